@@ -4,13 +4,15 @@
 #include <arpa/inet.h>
 #include <cstring>
 #include <signal.h>
-#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 // Step 1) include either cpptxrx_threadsafe.h (to make a threadsafe interface) or cpptxrx_raw.h (to create a non threadsafe interface)
 #include "../include/cpptxrx_threadsafe.h"
 
+// optionally, include cpptxrx_fd_waiter.h, which handles waiting on file descriptors until the next timeout, or wake_process
+#include "../include/cpptxrx_fd_waiter.h"
+
 // optionally, to differentiate new interface types its a good to place them in a namespace
 namespace udp
 {
@@ -99,15 +101,15 @@ namespace udp
         //      void process_send_receive() override;       (REQUIRED)
         //      void wake_process() override;               (OPTIONAL for raw, REQUIRED for threadsafe)
 
-        int socket_wake_fd = -1;
-        int socket_fd      = -1;
+        interface::fd_waiter waiter = {};
+        int socket_fd               = -1;
 
         void construct() override
         {
             signal(SIGPIPE, SIG_IGN);
 
-            socket_wake_fd = eventfd(0, EFD_NONBLOCK);
-            if (socket_wake_fd < 0)
+            // create the epoll set, and the eventfd used by wake_process
+            if (!waiter.construct(true))
                 raise(SIGSEGV);
         }
 
@@ -116,7 +118,7 @@ namespace udp
             if (socket_fd != -1 && ::close(socket_fd) == -1)
                 raise(SIGSEGV);
 
-            if (socket_wake_fd != -1 && ::close(socket_wake_fd) != 0)
+            if (!waiter.destruct())
                 raise(SIGSEGV);
         }
 
@@ -124,6 +126,7 @@ namespace udp
         {
             if (socket_fd == -1)
                 return true;
+            waiter.remove(socket_fd);
             if (::close(socket_fd) == -1)
             {
                 m_open_status.set_error_code(static_cast<unsigned int>(errno), "CLOSE_ERR");
@@ -143,8 +146,7 @@ namespace udp
         //       will be called precisely when your process_ method is performing a block or reading the wake signal.
         void wake_process() override
         {
-            uint64_t val = 1;
-            if (::write(socket_wake_fd, &val, sizeof(val)) != sizeof(val))
+            if (!waiter.wake())
                 raise(SIGSEGV);
         }
 
@@ -193,98 +195,58 @@ namespace udp
                 return;
             }
 
+            if (!waiter.add(socket_fd, 0u))
+            {
+                transactions.p_open_op->end_op_with_error_code(static_cast<unsigned int>(errno), "EPOLL_ADD_FAILURE");
+                close_socket();
+                return;
+            }
+
             transactions.p_open_op->end_op(interface::status_e::SUCCESS);
         }
 
         void process_send_receive() override
         {
-            // convert min_timeout to timeval
-            auto min_timeout = transactions.duration_until_timeout({transactions.p_recv_op, transactions.p_send_op});
-            auto seconds     = std::chrono::duration_cast<std::chrono::seconds>(min_timeout);
-            if (seconds > min_timeout)
-                seconds -= std::chrono::seconds{1};
-            timeval tv;
-            tv.tv_sec  = seconds.count();
-            tv.tv_usec = std::chrono::duration_cast<std::chrono::microseconds>(min_timeout - seconds).count();
-
             const bool receiving = transactions.p_recv_op != nullptr;
             const bool sending   = transactions.p_send_op != nullptr;
 
-            fd_set read_fds;
-            FD_ZERO(&read_fds);
-            FD_SET(socket_wake_fd, &read_fds);
-            if (receiving)
-                FD_SET(socket_fd, &read_fds);
-
-            fd_set write_fds;
-            if (sending)
-            {
-                FD_ZERO(&write_fds);
-                FD_SET(socket_fd, &write_fds);
-            }
-
-            fd_set except_fds;
-            FD_ZERO(&except_fds);
-            FD_SET(socket_fd, &except_fds);
-            FD_SET(socket_wake_fd, &except_fds);
-
-            int maxfd  = socket_fd > socket_wake_fd ? socket_fd : socket_wake_fd;
-            int events = ::select(maxfd + 1, &read_fds, sending ? &write_fds : NULL, &except_fds, &tv);
-
-            // check for a timeout
-            if (events == 0)
-                return;
-
-            // check for a select error
-            if (events < 0)
+            // wait for the socket to be readable if receiving, and writable if sending
+            if (!waiter.modify(socket_fd, (receiving ? static_cast<uint32_t>(EPOLLIN) : 0u) | (sending ? static_cast<uint32_t>(EPOLLOUT) : 0u)))
             {
                 if (sending)
-                    transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_ERROR_IN_TX");
+                    transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "EPOLL_MOD_ERROR_IN_TX");
                 if (receiving)
-                    transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_ERROR_IN_RX");
+                    transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "EPOLL_MOD_ERROR_IN_RX");
                 close_socket();
                 return;
             }
 
-            // check for a socket exception
-            if (FD_ISSET(socket_fd, &except_fds))
-            {
-                if (sending)
-                    transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_SOCK_EXCEPTION_IN_TX");
-                if (receiving)
-                    transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_SOCK_EXCEPTION_IN_RX");
-                close_socket();
+            // wait until the socket is ready, the nearest operation timeout passes, or wake_process() is called
+            epoll_event events[1];
+            int num_ready = waiter.wait(transactions, events);
+
+            // check for a timeout, or a wake up
+            if (num_ready == 0)
                 return;
-            }
 
-            // check for a eventfd exception
-            if (FD_ISSET(socket_wake_fd, &except_fds))
+            // check for a wait error
+            if (num_ready < 0)
             {
                 if (sending)
-                    transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_EFD_EXCEPTION_IN_TX");
+                    transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "EPOLL_ERROR_IN_TX");
                 if (receiving)
-                    transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_EFD_EXCEPTION_IN_RX");
+                    transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "EPOLL_ERROR_IN_RX");
                 close_socket();
                 return;
             }
 
-            // check to see if wake_process() was called
-            if (FD_ISSET(socket_wake_fd, &read_fds))
-            {
-                uint64_t val;
-                if (::read(socket_wake_fd, &val, sizeof(val)) == -1)
-                {
-                    if (sending)
-                        transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "EFD_READ_ERR_IN_TX");
-                    if (receiving)
-                        transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "EFD_READ_ERR_IN_RX");
-                    close_socket();
-                    return;
-                }
-            }
+            // a socket error makes it both readable and writable, so that the error is returned by recvfrom or sendto
+            const bool errored  = (events[0].events & (EPOLLERR | EPOLLHUP)) != 0u;
+            const bool readable = errored || (events[0].events & EPOLLIN) != 0u;
+            const bool writable = errored || (events[0].events & EPOLLOUT) != 0u;
 
             // check to see if the socket has data to be received
-            if (receiving && FD_ISSET(socket_fd, &read_fds))
+            if (receiving && readable)
             {
                 auto read_size = ::recvfrom(socket_fd, transactions.p_recv_op->received_data, transactions.p_recv_op->max_receive_size,
                                             0, reinterpret_cast<sockaddr *>(&m_open_opts.m_address), &m_open_opts.m_address_size);
@@ -302,7 +264,7 @@ namespace udp
             }
 
             // check to see if the socket is ready for a send
-            if (sending && FD_ISSET(socket_fd, &write_fds))
+            if (sending && writable)
             {
                 ssize_t send_size = ::sendto(socket_fd, transactions.p_send_op->send_data, transactions.p_send_op->send_size,
                                              0, reinterpret_cast<sockaddr *>(&m_open_opts.m_address), m_open_opts.m_address_size);
@@ -310,7 +272,7 @@ namespace udp
                     transactions.p_send_op->end_op(interface::status_e::SUCCESS);
                 else
                 {
-                    transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SENDTO_FAILED");
+                    transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SENDTO_FAILED");
                     close_socket();
                     return;
                 }
@@ -1,6 +1,7 @@
 /// @file cpptxrx_abstract.h
 /// @author Darren V Levine (DarrenVLevine@gmail.com)
-/// @brief defines a polymorphic abstract interface class that all other interfaces inherit from
+/// @brief defines a polymorphic abstract interface class that all other interfaces inherit from (unless they use static dispatch,
+/// where the "polymorphic" adapter can be used instead)
 ///
 /// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
 ///
@@ -105,6 +106,67 @@ namespace interface
         /// @return   status_e: the resulting status of the send
         virtual status_e send(const uint8_t *const data, size_t size) = 0;
 
+        /// @brief [[OPTIONAL]] sends bytes tagged with a priority class, with an absolute timeout. Interfaces that don't define
+        /// it send them at normal priority.
+        ///
+        /// @param    data: the bytes to send
+        /// @param    size: the number of bytes to send
+        /// @param    abs_timeout: how long to wait for the send to occur
+        /// @param    priority: the priority class of the send
+        /// @return   status_e: the resulting status of the send
+        virtual status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point abs_timeout, priority_e priority)
+        {
+            (void)priority;
+            return send(data, size, abs_timeout);
+        }
+
+        /// @brief [[OPTIONAL]] sends bytes tagged with a priority class, with a relative timeout. Interfaces that don't define
+        /// it send them at normal priority.
+        ///
+        /// @param    data: the bytes to send
+        /// @param    size: the number of bytes to send
+        /// @param    rel_timeout: how long to wait for the send to occur
+        /// @param    priority: the priority class of the send
+        /// @return   status_e: the resulting status of the send
+        virtual status_e send(const uint8_t *const data, size_t size, std::chrono::nanoseconds rel_timeout, priority_e priority)
+        {
+            return send(data, size, std::chrono::steady_clock::now() + rel_timeout, priority);
+        }
+
+        /// @brief [[OPTIONAL]] attempts to receive bytes once, without waiting, and without waking the management thread if the
+        /// interface supports it. Interfaces that don't define it return status_e::UNSUPPORTED_OP.
+        ///
+        /// @param    data: where the received data will be output
+        /// @param    size: the max number of bytes that can be received
+        /// @return   recv_ret: the final status (status_e::WOULD_BLOCK if nothing could be received right away), and number of bytes received
+        virtual recv_ret try_receive(uint8_t *const data, size_t size)
+        {
+            (void)data;
+            (void)size;
+            return {status_e::UNSUPPORTED_OP, 0u};
+        }
+
+        /// @brief [[OPTIONAL]] attempts to send bytes once, without waiting, and without waking the management thread if the
+        /// interface supports it. Interfaces that don't define it return status_e::UNSUPPORTED_OP.
+        ///
+        /// @param    data: the bytes to send
+        /// @param    size: the number of bytes to send
+        /// @return   status_e: the resulting status of the send (status_e::WOULD_BLOCK if it couldn't be sent right away)
+        virtual status_e try_send(const uint8_t *const data, size_t size)
+        {
+            (void)data;
+            (void)size;
+            return status_e::UNSUPPORTED_OP;
+        }
+
+        /// @brief [[OPTIONAL]] returns the timeout used by receive() when it's called without one, so that wrappers (like
+        /// interface::decorator) can use the same one. Interfaces that don't define it return the default of policy::timeouts<>.
+        virtual std::chrono::nanoseconds default_receive_timeout() const { return std::chrono::seconds(30); }
+
+        /// @brief [[OPTIONAL]] returns the timeout used by send() when it's called without one, so that wrappers (like
+        /// interface::decorator) can use the same one. Interfaces that don't define it return the default of policy::timeouts<>.
+        virtual std::chrono::nanoseconds default_send_timeout() const { return std::chrono::seconds(1); }
+
         /// @brief receives bytes on the connection, with a default timeout
         ///
         /// @param    data: where the received data will be output
@@ -182,6 +244,81 @@ namespace interface
         abstract(const abstract &)           = delete;
     };
 
+    /// @brief an opt-in adapter, that implements "abstract" for an interface that doesn't inherit it (like the ones using
+    /// interface::policy::static_dispatch), by forwarding each virtual method to the interface's own, so it can be used
+    /// polymorphically where needed without the interface itself paying for the virtual calls
+    ///
+    /// @tparam   static_interface_type: the interface type to wrap
+    template <typename static_interface_type>
+    class polymorphic final : public static_interface_type, public abstract
+    {
+    public:
+        using static_interface_type::static_interface_type;
+        using static_interface_type::operator bool;
+        using static_interface_type::open;
+        using static_interface_type::reopen;
+        using static_interface_type::receive;
+        using static_interface_type::send;
+
+        void destroy() override { static_interface_type::destroy(); }
+        const char *name() const override { return static_interface_type::name(); }
+        int id() const override { return static_interface_type::id(); }
+        bool is_threadsafe() const override { return static_interface_type::is_threadsafe(); }
+        bool is_open() const override { return static_interface_type::is_open(); }
+        status_e open_status() const override { return static_interface_type::open_status(); }
+        status_e reopen(std::chrono::steady_clock::time_point end_time) override { return static_interface_type::reopen(end_time); }
+        status_e reopen(std::chrono::nanoseconds timeout) override { return static_interface_type::reopen(timeout); }
+        status_e reopen() override { return static_interface_type::reopen(); }
+        status_e open(std::chrono::steady_clock::time_point end_time) override { return static_interface_type::open(end_time); }
+        status_e open(std::chrono::nanoseconds timeout) override { return static_interface_type::open(timeout); }
+        status_e open() override { return static_interface_type::open(); }
+        status_e close(std::chrono::steady_clock::time_point end_time) override { return static_interface_type::close(end_time); }
+        status_e close(std::chrono::nanoseconds timeout) override { return static_interface_type::close(timeout); }
+        status_e close() override { return static_interface_type::close(); }
+        recv_ret receive(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time) override
+        {
+            return static_interface_type::receive(data, size, end_time);
+        }
+        recv_ret receive(uint8_t *const data, size_t size, std::chrono::nanoseconds timeout) override
+        {
+            return static_interface_type::receive(data, size, timeout);
+        }
+        recv_ret receive(uint8_t *const data, size_t size) override
+        {
+            return static_interface_type::receive(data, size);
+        }
+        status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time) override
+        {
+            return static_interface_type::send(data, size, end_time);
+        }
+        status_e send(const uint8_t *const data, size_t size, std::chrono::nanoseconds timeout) override
+        {
+            return static_interface_type::send(data, size, timeout);
+        }
+        status_e send(const uint8_t *const data, size_t size) override
+        {
+            return static_interface_type::send(data, size);
+        }
+        status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, priority_e priority) override
+        {
+            return static_interface_type::send(data, size, end_time, priority);
+        }
+        status_e send(const uint8_t *const data, size_t size, std::chrono::nanoseconds timeout, priority_e priority) override
+        {
+            return static_interface_type::send(data, size, timeout, priority);
+        }
+        recv_ret try_receive(uint8_t *const data, size_t size) override
+        {
+            return static_interface_type::try_receive(data, size);
+        }
+        status_e try_send(const uint8_t *const data, size_t size) override
+        {
+            return static_interface_type::try_send(data, size);
+        }
+        std::chrono::nanoseconds default_receive_timeout() const override { return static_interface_type::default_receive_timeout(); }
+        std::chrono::nanoseconds default_send_timeout() const override { return static_interface_type::default_send_timeout(); }
+    };
+
     /// @brief the subset of member variables modifiable in a transaction (during the process_<open/close/send/receive> methods)
     ///
     /// @tparam   open_opts_type: your interface's open opts type
@@ -199,6 +336,16 @@ namespace interface
         /// methods, and can be queries and set asynchronously from other threads using the "get_open_args" and "set_open_args" methods
         open_opts_type m_open_opts{};
 
+        /// @brief [[OPTIONAL]] can be called from inside process_send_receive, each time its wait wakes up or it finishes an operation,
+        /// to hand the finished send/receive operations back to their callers and pick up any newly requested ones, without
+        /// having to return and restart the wait. Only threadsafe interfaces can pick up new operations this way. The factory's
+        /// version is final, so call it through the interface's own type (like from the interface, or a helper templated on its
+        /// type) rather than through a transactions_args reference, so that it's resolved statically.
+        ///
+        /// @return   true: if there are still send/receive operations active, and process_send_receive should keep waiting on them
+        /// @return   false: if process_send_receive should return, since there's nothing left to do or an open/close/destroy is waiting
+        virtual bool sync_send_receive() { return false; }
+
         // boilerplate:
         virtual ~transactions_args() = default;
     };
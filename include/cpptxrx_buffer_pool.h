@@ -0,0 +1,165 @@
+/// @file cpptxrx_buffer_pool.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines "interface::buffer_pool", a fixed set of equally sized buffers in one mapping, that's backed by huge pages
+/// when they're available, and placed on the NUMA node of the thread that fills them, for use by loaned buffer APIs like
+/// "interface::pooled_receive_ring"
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_BUFFER_POOL_H_
+#define CPPTXRX_BUFFER_POOL_H_
+
+#include "cpptxrx_op_backend.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+#if defined(__linux__) && __has_include(<linux/mempolicy.h>)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define CPPTXRX_HAS_MBIND 1
+#else
+#define CPPTXRX_HAS_MBIND 0
+#endif
+
+namespace interface
+{
+    /// @brief what backs the memory of a buffer_pool, from best to worst
+    enum class page_backing_e
+    {
+        HUGE_PAGES,             // explicitly reserved 2 MB pages (MAP_HUGETLB), which needs vm.nr_hugepages to be configured
+        TRANSPARENT_HUGE_PAGES, // normal pages, that the kernel was asked to merge into huge pages (MADV_HUGEPAGE)
+        NORMAL_PAGES,           // normal pages, since the pool is too small for huge pages, or they're not supported
+        NONE                    // the pool couldn't be mapped at all
+    };
+
+    /// @brief returns the NUMA node the calling thread is running on, or -1 if it's unknown
+    [[nodiscard]] inline int numa_node_of_calling_thread() noexcept
+    {
+#if CPPTXRX_HAS_MBIND && defined(SYS_getcpu)
+        unsigned int cpu  = 0u;
+        unsigned int node = 0u;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+            return static_cast<int>(node);
+#endif
+        return -1;
+    }
+
+    /// @brief a fixed set of equally sized buffers, in one mapping that's backed by huge pages when possible, so that a large
+    /// receive ring doesn't miss the TLB on every buffer. Nothing touches the memory until it's used, so by default each page
+    /// is placed on the NUMA node of the first thread to write it, which for receive buffers is the interface's management
+    /// thread, or it can be bound to a specific node instead. Every fallback is silent, so it always works, just slower.
+    class buffer_pool
+    {
+        static constexpr size_t huge_page_size = 2u * 1024u * 1024u;
+
+        uint8_t *p_region       = nullptr;
+        size_t region_size      = 0u;
+        size_t num_buffers      = 0u;
+        size_t bytes_per_buffer = 0u;
+        page_backing_e backing  = page_backing_e::NONE;
+        bool bound              = false;
+
+        static size_t round_up(size_t size, size_t multiple) noexcept
+        {
+            return (size + multiple - 1u) / multiple * multiple;
+        }
+
+        static uint8_t *map(size_t size, int flags) noexcept
+        {
+            void *p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+            return p == MAP_FAILED ? nullptr : static_cast<uint8_t *>(p);
+        }
+
+        bool bind_to_node(int numa_node) noexcept
+        {
+#if CPPTXRX_HAS_MBIND
+            // preferred rather than strict, so that a full node spills over instead of failing page faults
+            constexpr size_t bits_per_mask = 8u * sizeof(unsigned long);
+            if (numa_node < 0 || static_cast<size_t>(numa_node) >= bits_per_mask)
+                return false;
+            unsigned long node_mask = 1ul << static_cast<unsigned>(numa_node);
+            return syscall(SYS_mbind, p_region, region_size, MPOL_PREFERRED, &node_mask, bits_per_mask, 0u) == 0;
+#else
+            (void)numa_node;
+            return false;
+#endif
+        }
+
+    public:
+        /// @brief maps the buffers, trying huge pages first if the pool is at least one huge page, and then transparent huge pages,
+        /// and then normal pages. A pool too large to address isn't mapped.
+        ///
+        /// @param    buffer_count: the number of buffers
+        /// @param    buffer_size: the min number of bytes per buffer, rounded up to a whole number of cache lines
+        /// @param    numa_node: the NUMA node to prefer placing the pages on, or -1 to place each page on the node of the first
+        ///           thread to write to it
+        buffer_pool(size_t buffer_count, size_t buffer_size, int numa_node = -1) noexcept
+            : num_buffers(buffer_count),
+              bytes_per_buffer(buffer_size > SIZE_MAX - cache_line_size ? 0u : round_up(buffer_size > 0u ? buffer_size : 1u, cache_line_size))
+        {
+            if (num_buffers == 0u || bytes_per_buffer == 0u || num_buffers > (SIZE_MAX - huge_page_size) / bytes_per_buffer)
+            {
+                num_buffers = 0u;
+                return;
+            }
+            const size_t size = num_buffers * bytes_per_buffer;
+
+            // only worth a huge page when it's filled, since a smaller pool would pin a whole 2 MB page to a few buffers
+            if (size >= huge_page_size)
+            {
+                region_size = round_up(size, huge_page_size);
+                p_region    = map(region_size, MAP_HUGETLB);
+            }
+            if (p_region != nullptr)
+                backing = page_backing_e::HUGE_PAGES;
+            else
+            {
+                // huge pages aren't reserved (or supported), so fall back to normal pages, with a hint to merge them
+                region_size = round_up(size, static_cast<size_t>(::sysconf(_SC_PAGESIZE)));
+                p_region    = map(region_size, 0);
+                if (p_region == nullptr)
+                {
+                    num_buffers = 0u;
+                    region_size = 0u;
+                    return;
+                }
+                backing = page_backing_e::NORMAL_PAGES;
+#ifdef MADV_HUGEPAGE
+                if (region_size >= huge_page_size && ::madvise(p_region, region_size, MADV_HUGEPAGE) == 0)
+                    backing = page_backing_e::TRANSPARENT_HUGE_PAGES;
+#endif
+            }
+            if (numa_node >= 0)
+                bound = bind_to_node(numa_node);
+        }
+        buffer_pool(const buffer_pool &)            = delete;
+        buffer_pool &operator=(const buffer_pool &) = delete;
+        ~buffer_pool()
+        {
+            if (p_region != nullptr)
+                ::munmap(p_region, region_size);
+        }
+
+        /// @brief returns the i'th buffer, which is aligned to a cache line
+        [[nodiscard]] uint8_t *buffer(size_t i) const noexcept { return p_region + i * bytes_per_buffer; }
+
+        /// @brief returns the number of buffers, which is 0 if the pool couldn't be mapped
+        [[nodiscard]] size_t buffer_count() const noexcept { return num_buffers; }
+
+        /// @brief returns the number of bytes per buffer
+        [[nodiscard]] size_t buffer_size() const noexcept { return bytes_per_buffer; }
+
+        /// @brief returns what backs the pool's memory
+        [[nodiscard]] page_backing_e page_backing() const noexcept { return backing; }
+
+        /// @brief returns true if the pool was bound to the NUMA node it was given
+        [[nodiscard]] bool is_numa_bound() const noexcept { return bound; }
+
+        /// @brief returns true if the pool was mapped
+        explicit operator bool() const noexcept { return p_region != nullptr; }
+    };
+} // namespace interface
+
+#endif // CPPTXRX_BUFFER_POOL_H_
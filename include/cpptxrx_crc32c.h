@@ -0,0 +1,368 @@
+/// @file cpptxrx_crc32c.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines "interface::crc32c", a CRC32C (Castagnoli) checksum that uses the SSE4.2 or ARMv8 CRC instructions when
+/// the CPU has them, and "interface::crc32c_integrity", a decorator that appends and verifies a CRC32C trailer on every message
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_CRC32C_H_
+#define CPPTXRX_CRC32C_H_
+
+#include "cpptxrx_decorator.h"
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define CPPTXRX_HAS_SSE42_CRC32C 1
+#else
+#define CPPTXRX_HAS_SSE42_CRC32C 0
+#endif
+
+#if defined(__aarch64__) && defined(__linux__) && (defined(__GNUC__) || defined(__clang__)) && __has_include(<arm_acle.h>)
+#include <arm_acle.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#define CPPTXRX_HAS_ARMV8_CRC32C 1
+#else
+#define CPPTXRX_HAS_ARMV8_CRC32C 0
+#endif
+
+namespace interface
+{
+    /// @brief the lookup tables used by the CRC32C implementations, which are all generated at compile time
+    struct crc32c_tables
+    {
+        static constexpr uint32_t polynomial = 0x82F63B78u; // reflected 0x1EDC6F41
+
+        // the "slicing by 8" tables for the table driven fallback, where slices[k][i] is the CRC of byte i followed by k zeros
+        uint32_t slices[8][256] = {};
+
+        // the tables that shift a CRC past a block of zeros, used to combine the CRCs of blocks that were computed in parallel
+        // by the CRC instructions (whose latency is 3 times their throughput) into one
+        static constexpr size_t short_block = 256u;
+        static constexpr size_t long_block  = 2048u;
+        uint32_t short_shift[4][256] = {};
+        uint32_t long_shift[4][256]  = {};
+
+        static constexpr uint32_t gf2_matrix_times(const uint32_t (&mat)[32], uint32_t vec)
+        {
+            uint32_t sum = 0u;
+            for (size_t n = 0; vec != 0u; vec >>= 1u, n++)
+                if ((vec & 1u) != 0u)
+                    sum ^= mat[n];
+            return sum;
+        }
+
+        static constexpr void gf2_matrix_square(uint32_t (&square)[32], const uint32_t (&mat)[32])
+        {
+            for (size_t n = 0; n < 32u; n++)
+                square[n] = gf2_matrix_times(mat, mat[n]);
+        }
+
+        /// @brief fills "shift" with the tables for the operator that appends "len" zero bytes to a message
+        static constexpr void make_shift_tables(uint32_t (&shift)[4][256], size_t len)
+        {
+            // the operator for one zero bit, and then two, and then four, by repeated squaring
+            uint32_t odd[32]  = {};
+            uint32_t even[32] = {};
+            odd[0]            = polynomial;
+            for (size_t n = 1; n < 32u; n++)
+                odd[n] = 1u << (n - 1u);
+            gf2_matrix_square(even, odd);
+            gf2_matrix_square(odd, even);
+
+            // keep squaring, from one zero byte, until "len" (a power of two) is reached, since each of its bits is one squaring
+            bool in_even = false;
+            for (; len != 0u; len >>= 1u)
+            {
+                if (in_even)
+                    gf2_matrix_square(odd, even);
+                else
+                    gf2_matrix_square(even, odd);
+                in_even = !in_even;
+            }
+            const uint32_t(&op)[32] = in_even ? even : odd;
+            for (uint32_t n = 0; n < 256u; n++)
+                for (uint32_t byte = 0; byte < 4u; byte++)
+                    shift[byte][n] = gf2_matrix_times(op, n << (8u * byte));
+        }
+
+        constexpr crc32c_tables()
+        {
+            for (uint32_t n = 0; n < 256u; n++)
+            {
+                uint32_t crc = n;
+                for (size_t bit = 0; bit < 8u; bit++)
+                    crc = (crc & 1u) != 0u ? (crc >> 1u) ^ polynomial : crc >> 1u;
+                slices[0][n] = crc;
+            }
+            for (size_t k = 1; k < 8u; k++)
+                for (size_t n = 0; n < 256u; n++)
+                    slices[k][n] = (slices[k - 1u][n] >> 8u) ^ slices[0][slices[k - 1u][n] & 0xFFu];
+
+            make_shift_tables(short_shift, short_block);
+            make_shift_tables(long_shift, long_block);
+        }
+
+        /// @brief returns the (pre and post inverted) CRC of "len" zeros appended to a message with the given CRC, where
+        /// "len" is short_block or long_block
+        static inline uint32_t shift(const uint32_t (&table)[4][256], uint32_t crc) noexcept
+        {
+            return table[0][crc & 0xFFu] ^ table[1][(crc >> 8u) & 0xFFu] ^ table[2][(crc >> 16u) & 0xFFu] ^ table[3][crc >> 24u];
+        }
+    };
+    inline constexpr crc32c_tables crc32c_lookup{};
+
+    /// @brief the portable CRC32C, processing 8 bytes per step with the "slicing by 8" tables
+    ///
+    /// @param    crc: the CRC of the data before this data, or 0 to start a new CRC
+    /// @param    data: the data to checksum
+    /// @param    size: the number of bytes to checksum
+    /// @return   uint32_t: the CRC of all the data so far
+    inline uint32_t crc32c_table_driven(uint32_t crc, const uint8_t *data, size_t size) noexcept
+    {
+        const auto &t = crc32c_lookup.slices;
+        crc           = ~crc;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        for (; size >= 8u; size -= 8u, data += 8u)
+        {
+            uint64_t word;
+            memcpy(&word, data, sizeof(word));
+            const uint32_t lo = crc ^ static_cast<uint32_t>(word);
+            const uint32_t hi = static_cast<uint32_t>(word >> 32u);
+            crc               = t[7][lo & 0xFFu] ^ t[6][(lo >> 8u) & 0xFFu] ^ t[5][(lo >> 16u) & 0xFFu] ^ t[4][lo >> 24u] ^
+                  t[3][hi & 0xFFu] ^ t[2][(hi >> 8u) & 0xFFu] ^ t[1][(hi >> 16u) & 0xFFu] ^ t[0][hi >> 24u];
+        }
+#endif
+        for (; size > 0u; size--, data++)
+            crc = t[0][(crc ^ *data) & 0xFFu] ^ (crc >> 8u);
+        return ~crc;
+    }
+
+#if CPPTXRX_HAS_SSE42_CRC32C
+    /// @brief the CRC32C using the SSE4.2 crc32 instruction, on three interleaved blocks at a time to hide its latency
+    __attribute__((target("sse4.2"))) inline uint32_t crc32c_sse42(uint32_t crc, const uint8_t *data, size_t size) noexcept
+    {
+#if defined(__x86_64__)
+        using word_type = uint64_t;
+        auto step       = [](uint64_t c, const uint8_t *p) __attribute__((target("sse4.2")))
+        {
+            uint64_t word;
+            memcpy(&word, p, sizeof(word));
+            return static_cast<uint64_t>(_mm_crc32_u64(c, word));
+        };
+#else
+        using word_type = uint32_t;
+        auto step       = [](uint32_t c, const uint8_t *p) __attribute__((target("sse4.2")))
+        {
+            uint32_t word;
+            memcpy(&word, p, sizeof(word));
+            return _mm_crc32_u32(c, word);
+        };
+#endif
+        word_type crc0 = ~crc;
+        for (const size_t block : {crc32c_tables::long_block, crc32c_tables::short_block})
+        {
+            const auto &shift_table = block == crc32c_tables::long_block ? crc32c_lookup.long_shift : crc32c_lookup.short_shift;
+            for (; size >= 3u * block; size -= 3u * block, data += 3u * block)
+            {
+                word_type crc1 = 0u;
+                word_type crc2 = 0u;
+                for (size_t i = 0; i < block; i += sizeof(word_type))
+                {
+                    crc0 = step(crc0, data + i);
+                    crc1 = step(crc1, data + block + i);
+                    crc2 = step(crc2, data + 2u * block + i);
+                }
+                crc0 = crc32c_tables::shift(shift_table, static_cast<uint32_t>(crc0)) ^ static_cast<uint32_t>(crc1);
+                crc0 = crc32c_tables::shift(shift_table, static_cast<uint32_t>(crc0)) ^ static_cast<uint32_t>(crc2);
+            }
+        }
+        for (; size >= sizeof(word_type); size -= sizeof(word_type), data += sizeof(word_type))
+            crc0 = step(crc0, data);
+        uint32_t crc_out = static_cast<uint32_t>(crc0);
+        for (; size > 0u; size--, data++)
+            crc_out = _mm_crc32_u8(crc_out, *data);
+        return ~crc_out;
+    }
+#endif
+
+#if CPPTXRX_HAS_ARMV8_CRC32C
+    /// @brief the CRC32C using the ARMv8 crc32c instructions, on three interleaved blocks at a time to hide their latency
+    __attribute__((target("+crc"))) inline uint32_t crc32c_armv8(uint32_t crc, const uint8_t *data, size_t size) noexcept
+    {
+        uint32_t crc0 = ~crc;
+        for (const size_t block : {crc32c_tables::long_block, crc32c_tables::short_block})
+        {
+            const auto &shift_table = block == crc32c_tables::long_block ? crc32c_lookup.long_shift : crc32c_lookup.short_shift;
+            for (; size >= 3u * block; size -= 3u * block, data += 3u * block)
+            {
+                uint32_t crc1 = 0u;
+                uint32_t crc2 = 0u;
+                for (size_t i = 0; i < block; i += sizeof(uint64_t))
+                {
+                    uint64_t words[3];
+                    memcpy(&words[0], data + i, sizeof(uint64_t));
+                    memcpy(&words[1], data + block + i, sizeof(uint64_t));
+                    memcpy(&words[2], data + 2u * block + i, sizeof(uint64_t));
+                    crc0 = __crc32cd(crc0, words[0]);
+                    crc1 = __crc32cd(crc1, words[1]);
+                    crc2 = __crc32cd(crc2, words[2]);
+                }
+                crc0 = crc32c_tables::shift(shift_table, crc0) ^ crc1;
+                crc0 = crc32c_tables::shift(shift_table, crc0) ^ crc2;
+            }
+        }
+        for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), data += sizeof(uint64_t))
+        {
+            uint64_t word;
+            memcpy(&word, data, sizeof(word));
+            crc0 = __crc32cd(crc0, word);
+        }
+        for (; size > 0u; size--, data++)
+            crc0 = __crc32cb(crc0, *data);
+        return ~crc0;
+    }
+#endif
+
+    /// @brief a CRC32C implementation, and its name
+    struct crc32c_implementation
+    {
+        uint32_t (*compute)(uint32_t, const uint8_t *, size_t) noexcept;
+        const char *name;
+    };
+
+    /// @brief returns the fastest CRC32C implementation the CPU supports, which is picked once, the first time it's called
+    [[nodiscard]] inline const crc32c_implementation &crc32c_best_implementation() noexcept
+    {
+        static const crc32c_implementation best = []() -> crc32c_implementation
+        {
+#if CPPTXRX_HAS_SSE42_CRC32C
+            if (__builtin_cpu_supports("sse4.2"))
+                return {&crc32c_sse42, "sse4.2"};
+#endif
+#if CPPTXRX_HAS_ARMV8_CRC32C
+            if ((getauxval(AT_HWCAP) & HWCAP_CRC32) != 0u)
+                return {&crc32c_armv8, "armv8"};
+#endif
+            return {&crc32c_table_driven, "table"};
+        }();
+        return best;
+    }
+
+    /// @brief returns the CRC32C (Castagnoli) of the data, using the fastest implementation the CPU supports
+    ///
+    /// @param    data: the data to checksum
+    /// @param    size: the number of bytes to checksum
+    /// @param    crc (optional): the CRC of the data before this data, to continue a CRC over several buffers
+    /// @return   uint32_t: the CRC of all the data so far
+    [[nodiscard]] inline uint32_t crc32c(const uint8_t *data, size_t size, uint32_t crc = 0u) noexcept
+    {
+        return crc32c_best_implementation().compute(crc, data, size);
+    }
+
+    /// @brief the counts of messages checked by a crc32c_integrity decorator
+    struct integrity_stats
+    {
+        uint64_t verified = 0u; // received messages whose CRC matched
+        uint64_t corrupt  = 0u; // received messages that were dropped since their CRC didn't match (or they were too short)
+    };
+
+    /// @brief a decorator that appends a 4 byte CRC32C trailer to every message sent, and verifies it on every message received,
+    /// dropping (and counting) any that are corrupt, so that the caller only ever receives intact messages, with the trailer
+    /// removed. This is much stronger than UDP's 16 bit checksum, and is computed with the CPU's CRC instructions when it has
+    /// them. Receive buffers need room for the 4 byte trailer too, otherwise the message is returned unverified, with a
+    /// status_e::SEE_ERROR_CODE of EMSGSIZE. It can be used from any number of threads at a time.
+    ///
+    /// @tparam   max_message_size: the largest message that can be sent (see decorator::send_with_trailer)
+    template <size_t max_message_size = 1472u>
+    class crc32c_integrity : public decorator
+    {
+        // counted with atomic read-modify-writes, since any number of threads can receive at a time
+        std::atomic<uint64_t> verified{0u};
+        std::atomic<uint64_t> corrupt{0u};
+
+        static inline void store_trailer(uint8_t *p, uint32_t crc) noexcept
+        {
+            for (size_t i = 0; i < trailer_size; i++)
+                p[i] = static_cast<uint8_t>(crc >> (8u * i));
+        }
+        static inline uint32_t load_trailer(const uint8_t *p) noexcept
+        {
+            uint32_t crc = 0u;
+            for (size_t i = 0; i < trailer_size; i++)
+                crc |= static_cast<uint32_t>(p[i]) << (8u * i);
+            return crc;
+        }
+
+        /// @brief checks a received message, and removes its trailer if it's intact
+        ///
+        /// @return   true: if the message is corrupt, and should be dropped
+        bool drop_if_corrupt(const uint8_t *data, recv_ret &result) noexcept
+        {
+            if (!received_whole(result))
+                return false;
+            if (result.size < trailer_size || crc32c(data, result.size - trailer_size) != load_trailer(data + result.size - trailer_size))
+            {
+                corrupt.fetch_add(1u, std::memory_order_relaxed);
+                return true;
+            }
+            result.size -= trailer_size;
+            verified.fetch_add(1u, std::memory_order_relaxed);
+            return false;
+        }
+
+        status_e send_checked(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking,
+                              priority_e priority)
+        {
+            auto append_crc = [](uint8_t *framed, size_t message_size)
+            { store_trailer(framed + message_size, crc32c(framed, message_size)); };
+            return send_with_trailer<max_message_size, trailer_size>(data, size, end_time, blocking, priority, append_crc);
+        }
+
+        recv_ret receive_checked(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking)
+        {
+            return receive_until_kept(data, size, end_time, blocking, [this](const uint8_t *message, recv_ret &result)
+                                      { return drop_if_corrupt(message, result); });
+        }
+
+    public:
+        /// @brief the number of bytes added to the end of every message
+        static constexpr size_t trailer_size = 4u;
+
+        using decorator::decorator;
+        using decorator::receive;
+        using decorator::send;
+
+        /// @brief returns the counts of the messages checked so far
+        [[nodiscard]] integrity_stats stats() const noexcept
+        {
+            integrity_stats report{};
+            report.verified = verified.load(std::memory_order_relaxed);
+            report.corrupt  = corrupt.load(std::memory_order_relaxed);
+            return report;
+        }
+
+        status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, priority_e priority) override
+        {
+            return send_checked(data, size, end_time, true, priority);
+        }
+        recv_ret receive(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time) override
+        {
+            return receive_checked(data, size, end_time, true);
+        }
+        status_e try_send(const uint8_t *const data, size_t size) override
+        {
+            return send_checked(data, size, std::chrono::steady_clock::time_point::max(), false, priority_e::NORMAL);
+        }
+        recv_ret try_receive(uint8_t *const data, size_t size) override
+        {
+            return receive_checked(data, size, std::chrono::steady_clock::time_point::max(), false);
+        }
+    };
+} // namespace interface
+
+#endif // CPPTXRX_CRC32C_H_
@@ -0,0 +1,114 @@
+/// @file cpptxrx_deadline_heap.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines "interface::deadline_heap", a fixed capacity d-ary min-heap of items keyed on their deadline, used to hand
+/// queued sends to the management thread earliest deadline first (see policy::deadline_send_order)
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_DEADLINE_HEAP_H_
+#define CPPTXRX_DEADLINE_HEAP_H_
+
+#include <chrono>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace interface
+{
+    /// @brief a fixed capacity d-ary min-heap of item pointers, ordered by deadline, and then by insertion order for equal
+    /// deadlines, so that it never allocates, and items with the same deadline keep their first-in-first-out order
+    ///
+    /// @tparam   T: the type of item pointed to
+    /// @tparam   capacity: the max number of items held at once
+    /// @tparam   arity: the number of children per node, where wider heaps are shallower, trading more compares per level for
+    ///           fewer levels (and cache lines) touched per push and pop
+    template <typename T, size_t capacity, size_t arity>
+    class deadline_heap
+    {
+        static_assert(capacity > 0u, "the heap needs room for at least one item");
+        static_assert(arity >= 2u, "a heap needs at least two children per node");
+
+        struct entry
+        {
+            std::chrono::steady_clock::time_point deadline; // a copy of the item's deadline, so comparing doesn't touch the item
+            uint64_t sequence;
+            T *p_item;
+        };
+
+        entry entries[capacity] = {};
+        size_t count            = 0u;
+        uint64_t next_sequence  = 0u;
+
+        static inline bool earlier(const entry &a, const entry &b) noexcept
+        {
+            return a.deadline < b.deadline || (a.deadline == b.deadline && a.sequence < b.sequence);
+        }
+
+    public:
+        [[nodiscard]] inline bool empty() const noexcept { return count == 0u; }
+        [[nodiscard]] inline bool full() const noexcept { return count == capacity; }
+        [[nodiscard]] inline size_t size() const noexcept { return count; }
+
+        /// @brief adds an item, the heap must not be full
+        ///
+        /// @param    p_item: the item to add
+        /// @param    deadline: the deadline to order the item by
+        inline void push(T *p_item, std::chrono::steady_clock::time_point deadline) noexcept
+        {
+            const entry added{deadline, next_sequence++, p_item};
+
+            // sift up, moving parents down until the added entry's place is found
+            size_t i = count++;
+            while (i > 0u)
+            {
+                const size_t parent = (i - 1u) / arity;
+                if (!earlier(added, entries[parent]))
+                    break;
+                entries[i] = entries[parent];
+                i          = parent;
+            }
+            entries[i] = added;
+        }
+
+        /// @brief returns the item with the earliest deadline, the heap must not be empty
+        [[nodiscard]] inline T *top() const noexcept
+        {
+            return entries[0].p_item;
+        }
+
+        /// @brief removes and returns the item with the earliest deadline, the heap must not be empty
+        inline T *pop() noexcept
+        {
+            T *p_top          = entries[0].p_item;
+            const entry moved = entries[--count];
+
+            // sift down the last entry from the root, moving the earliest child up until the moved entry's place is found
+            size_t i = 0u;
+            while (true)
+            {
+                const size_t first_child = i * arity + 1u;
+                if (first_child >= count)
+                    break;
+                const size_t end_child = first_child + arity < count ? first_child + arity : count;
+                size_t earliest        = first_child;
+                for (size_t child = first_child + 1u; child < end_child; child++)
+                    if (earlier(entries[child], entries[earliest]))
+                        earliest = child;
+                if (!earlier(entries[earliest], moved))
+                    break;
+                entries[i] = entries[earliest];
+                i          = earliest;
+            }
+            if (count > 0u)
+                entries[i] = moved;
+            return p_top;
+        }
+
+        /// @brief removes every item
+        inline void clear() noexcept
+        {
+            count = 0u;
+        }
+    };
+} // namespace interface
+
+#endif // CPPTXRX_DEADLINE_HEAP_H_
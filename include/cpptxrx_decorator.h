@@ -0,0 +1,174 @@
+/// @file cpptxrx_decorator.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines "interface::decorator", the base class of the stages that wrap any "interface::abstract" to transform the
+/// messages sent and received through it (like interface::crc32c_integrity)
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_DECORATOR_H_
+#define CPPTXRX_DECORATOR_H_
+
+#include "cpptxrx_abstract.h"
+#include <atomic>
+#include <chrono>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace interface
+{
+    /// @brief an "abstract" interface that forwards everything to an inner interface, which stages inherit from to transform
+    /// the messages passing through. Stages only override the absolute timeout receive, the absolute timeout send with a
+    /// priority, and try_send/try_receive, since the other overloads are converted to those here (untagged sends at normal
+    /// priority), and the priority is passed on to the inner interface's send. Decorators run on the calling threads, so they
+    /// can be stacked (like sequencing on top of integrity checking) around any interface. Send and receive called without a
+    /// timeout use the default timeouts of the inner interface. The protected helpers hold what stages have in common, like
+    /// appending a trailer to each message sent, and dropping received messages until one passes the stage's checks.
+    class decorator : public abstract
+    {
+    protected:
+        /// @brief the wrapped interface, which must outlive the decorator
+        abstract &inner;
+
+        /// @brief adds to one of a stage's counts, which are only written by one thread at a time (like the receiving thread),
+        /// and read by stats() from any thread, so that they don't need atomic read-modify-writes
+        static inline void increment(std::atomic<uint64_t> &counter, uint64_t amount = 1u) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        /// @brief returns the error for a message larger than the stage's max_message_size
+        static status_e too_large() noexcept
+        {
+            status_e status = status_e::SEE_ERROR_CODE;
+            status.set_error_code(EMSGSIZE, "MESSAGE_LARGER_THAN_MAX_MESSAGE_SIZE");
+            return status;
+        }
+
+        /// @brief checks that a received message can be inspected, where a truncated one is returned as an EMSGSIZE error
+        /// instead, since the end of it (like its trailer) was cut off
+        ///
+        /// @return   true: if the message was received whole, so that the stage should check it
+        /// @return   false: if the result should be returned to the caller as it is
+        static bool received_whole(recv_ret &result) noexcept
+        {
+            if (result.status != status_e::SUCCESS)
+                return false;
+            if (result.truncated)
+            {
+                result.status = status_e::SEE_ERROR_CODE;
+                result.status.set_error_code(EMSGSIZE, "DECORATOR_TRAILER_TRUNCATED");
+                return false;
+            }
+            return true;
+        }
+
+        /// @brief sends to the inner interface, with send() at the given priority if blocking, or try_send() if not
+        status_e send_inner(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking,
+                            priority_e priority)
+        {
+            return blocking ? inner.send(data, size, end_time, priority) : inner.try_send(data, size);
+        }
+
+        /// @brief receives from the inner interface, with receive() if blocking, or try_receive() if not
+        recv_ret receive_inner(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking)
+        {
+            return blocking ? inner.receive(data, size, end_time) : inner.try_receive(data, size);
+        }
+
+        /// @brief copies a message onto the sending thread's stack, followed by a trailer, and sends them as one message, which
+        /// is why a stage that appends a trailer has a max_message_size
+        ///
+        /// @tparam   max_message_size: the largest message that can be sent, where larger ones fail with EMSGSIZE
+        /// @tparam   trailer_size: the number of bytes appended
+        /// @param    write_trailer: called with the copy, and the size of the message in it, to write the trailer after it
+        template <size_t max_message_size, size_t trailer_size, typename trailer_function>
+        status_e send_with_trailer(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking,
+                                   priority_e priority, trailer_function &&write_trailer)
+        {
+            if (size > max_message_size)
+                return too_large();
+            uint8_t framed[max_message_size + trailer_size];
+            memcpy(framed, data, size);
+            write_trailer(framed, size);
+            return send_inner(framed, size + trailer_size, end_time, blocking, priority);
+        }
+
+        /// @brief receives from the inner interface until a message isn't dropped
+        ///
+        /// @param    drop: called with each received message and its result (which it can modify, like to remove a trailer),
+        ///           returning true to drop the message and receive the next one
+        template <typename drop_function>
+        recv_ret receive_until_kept(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking,
+                                    drop_function &&drop)
+        {
+            while (true)
+            {
+                recv_ret result = receive_inner(data, size, end_time, blocking);
+                if (!drop(data, result))
+                    return result;
+            }
+        }
+
+    public:
+        using abstract::receive;
+        using abstract::send;
+
+        /// @brief wraps an interface
+        ///
+        /// @param    inner_interface: the interface to wrap, which must outlive the decorator
+        explicit decorator(abstract &inner_interface) : inner(inner_interface) {}
+
+        void destroy() override { inner.destroy(); }
+        const char *name() const override { return inner.name(); }
+        int id() const override { return inner.id(); }
+        bool is_threadsafe() const override { return inner.is_threadsafe(); }
+        bool is_open() const override { return inner.is_open(); }
+        status_e open_status() const override { return inner.open_status(); }
+        status_e reopen(std::chrono::steady_clock::time_point end_time) override { return inner.reopen(end_time); }
+        status_e reopen(std::chrono::nanoseconds timeout) override { return inner.reopen(timeout); }
+        status_e reopen() override { return inner.reopen(); }
+        status_e open(std::chrono::steady_clock::time_point end_time) override { return inner.open(end_time); }
+        status_e open(std::chrono::nanoseconds timeout) override { return inner.open(timeout); }
+        status_e open() override { return inner.open(); }
+        status_e close(std::chrono::steady_clock::time_point end_time) override { return inner.close(end_time); }
+        status_e close(std::chrono::nanoseconds timeout) override { return inner.close(timeout); }
+        status_e close() override { return inner.close(); }
+        std::chrono::nanoseconds default_receive_timeout() const override { return inner.default_receive_timeout(); }
+        std::chrono::nanoseconds default_send_timeout() const override { return inner.default_send_timeout(); }
+
+        recv_ret receive(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time) override
+        {
+            return inner.receive(data, size, end_time);
+        }
+        recv_ret receive(uint8_t *const data, size_t size, std::chrono::nanoseconds timeout) override
+        {
+            return receive(data, size, std::chrono::steady_clock::now() + timeout);
+        }
+        recv_ret receive(uint8_t *const data, size_t size) override
+        {
+            return receive(data, size, default_receive_timeout());
+        }
+        status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time) override
+        {
+            return send(data, size, end_time, priority_e::NORMAL);
+        }
+        status_e send(const uint8_t *const data, size_t size, std::chrono::nanoseconds timeout) override
+        {
+            return send(data, size, std::chrono::steady_clock::now() + timeout);
+        }
+        status_e send(const uint8_t *const data, size_t size) override
+        {
+            return send(data, size, default_send_timeout());
+        }
+        status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, priority_e priority) override
+        {
+            return inner.send(data, size, end_time, priority);
+        }
+        recv_ret try_receive(uint8_t *const data, size_t size) override { return inner.try_receive(data, size); }
+        status_e try_send(const uint8_t *const data, size_t size) override { return inner.try_send(data, size); }
+    };
+} // namespace interface
+
+#endif // CPPTXRX_DECORATOR_H_
@@ -1,148 +1,290 @@
+/// @file cpptxrx_factory.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines the "interface::factory" class template, which is the policy configured base class behind both
+/// "interface::thread_safe" and "interface::raw"
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
 #ifndef CPPTXRX_FACTORY_H_
 #define CPPTXRX_FACTORY_H_
 
 #include "cpptxrx_abstract.h"
+#include "cpptxrx_deadline_heap.h"
+#include "cpptxrx_handoff.h"
 #include "cpptxrx_macros.h"
 #include "cpptxrx_op_backend.h"
-
-#ifdef CPPTXRX_CLASS_NAME
-#undef CPPTXRX_CLASS_NAME
-#endif
-#if CPPTXRX_THREADSAFE
-#define CPPTXRX_CLASS_NAME threadsafe_factory
+#include "cpptxrx_policies.h"
 #include "cpptxrx_raii_thread.h"
+#include "cpptxrx_receive_ring.h"
+#include "cpptxrx_snapshot.h"
+#include <atomic>
 #include <condition_variable>
+#include <errno.h>
 #include <mutex>
-#else
-#define CPPTXRX_CLASS_NAME raw_factory
-#endif
+#include <optional>
+#include <type_traits>
 
 namespace interface
 {
-    /// @brief a generator for an inheritable base class for creating both thread safe and non thread safe CppTxRx interfaces
+    /// @brief declares the wake_process method, which is only required if the process_ methods run on a management thread.
+    /// It extends transactions_args, rather than being a separate base class, so that it doesn't add another vtable pointer.
     ///
     /// @tparam   open_opts_type: options type to use when calling "open"
-    /// @tparam   default_recv_timeout_ns (optional): default recv timeout in ns
-    /// @tparam   default_send_timeout_ns (optional): default send timeout in ns
-    /// @tparam   default_open_timeout_ns (optional): default open timeout in ns
-    /// @tparam   default_clse_timeout_ns (optional): default close timeout in ns
-    template <typename open_opts_type,
-              uint64_t default_recv_timeout_ns,
-              uint64_t default_send_timeout_ns,
-              uint64_t default_open_timeout_ns,
-              uint64_t default_clse_timeout_ns>
-    class CPPTXRX_CLASS_NAME : protected transactions_args<open_opts_type>, public abstract
+    /// @tparam   required: true if wake_process must be overridden
+    /// @tparam   is_virtual: false if the hooks are resolved statically (see policy::static_dispatch)
+    template <typename open_opts_type, bool required, bool is_virtual>
+    class wake_process_hook;
+
+    template <typename open_opts_type>
+    class wake_process_hook<open_opts_type, true, true> : protected transactions_args<open_opts_type>
+    {
+    protected:
+        /// @brief [[only REQUIRED for interface::threadsafe]]
+        /// Used to wake up a process_open/close/send_receive call that is blocking when another operation is requested.
+        /// WARNING!: wake_process is the only "overridden" method that can be called from other threads.
+        /// WARNING!: The wake signal must be sticky (like a eventfd object), since there's no guarantee that wake_process
+        ///           will be called precisely when your process_ method is performing a block or reading the wake signal.
+        virtual void wake_process() = 0;
+    };
+
+    template <typename open_opts_type>
+    class wake_process_hook<open_opts_type, false, true> : protected transactions_args<open_opts_type>
+    {
+    protected:
+        /// @brief [[OPTIONAL for interface::raw]] never called, since the process_ methods run on the calling thread
+        virtual void wake_process() {}
+    };
+
+    template <typename open_opts_type>
+    class wake_process_hook<open_opts_type, true, false> : protected transactions_args<open_opts_type>
+    {
+        // the final class must define wake_process, which fails to compile if it doesn't
+    };
+
+    template <typename open_opts_type>
+    class wake_process_hook<open_opts_type, false, false> : protected transactions_args<open_opts_type>
+    {
+    protected:
+        void wake_process() {}
+    };
+
+    /// @brief declares the rest of the hooks that a backend defines, either as virtual methods, or as plain methods that the
+    /// final class shadows and the factory calls through the final class's type (see policy::static_dispatch)
+    ///
+    /// @tparam   open_opts_type: options type to use when calling "open"
+    /// @tparam   threadsafe: true if the process_ methods run on a management thread
+    /// @tparam   is_virtual: false if the hooks are resolved statically
+    template <typename open_opts_type, bool threadsafe, bool is_virtual>
+    class backend_hooks;
+
+    template <typename open_opts_type, bool threadsafe>
+    class backend_hooks<open_opts_type, threadsafe, true> : protected wake_process_hook<open_opts_type, threadsafe, true>
+    {
+    protected:
+        /// @brief [[OPTIONAL]] Define how to construct your interface. Will only be called once.
+        /// Make sure to use this instead of a constructor, if you need one, so that you can call
+        /// virtual methods in this constructor.
+        virtual void construct() {}
+
+        /// @brief [[OPTIONAL]] Define how to destruct your interface. Will only be called once.
+        virtual void destruct() {}
+
+        /// @brief [[OPTIONAL]] Define how many file descriptors your interface holds, to be included in footprint() reports.
+        /// WARNING!: can be called from any thread, so the count should be tracked atomically.
+        virtual size_t fds_used() const { return 0u; }
+
+        /// @brief [[REQUIRED]] Meant to handle the close operation, held in the "transactions.p_close_op"
+        /// variable, which is guaranteed to never nullptr in the method.
+        virtual void process_close() = 0;
+
+        /// @brief [[REQUIRED]] Meant to handle the open operation, held in the "transactions.p_open_op"
+        /// variable, which is guaranteed to never nullptr in the method.
+        virtual void process_open() = 0;
+
+        /// @brief [[REQUIRED]] Meant to handle a send operation, a receive operation, or both simultaneously.
+        /// The "transactions.p_send_op", and "transactions.p_receive_op" pointers are not nullptr when
+        /// their operation is requested (and are always nullptr if the direction policy compiled their operation out).
+        /// It's also called once "transactions.next_wakeup" passes, for periodic work, so rather than waiting in a loop for
+        /// it, wait for at most "transactions.duration_until_wakeup()".
+        virtual void process_send_receive() = 0;
+
+        /// @brief [[OPTIONAL for interface::threadsafe]] Define how long the management thread can sit idle (with no operations
+        /// requested, "transactions.idle_in_send_recv" false, and the connection not open) before it exits, to save the thread's
+        /// resources in large fleets of mostly idle interfaces. It is restarted on demand when another operation is requested.
+        /// Is only ever called from the management thread, and defaults to never retiring the thread.
+        ///
+        /// @return   std::chrono::nanoseconds: the quiet period, or std::chrono::nanoseconds::max() to never retire the thread
+        virtual std::chrono::nanoseconds idle_thread_timeout() const { return std::chrono::nanoseconds::max(); }
+
+        /// @brief [[OPTIONAL for interface::threadsafe]] Define the stack size of the management thread in bytes, to reduce the
+        /// memory reserved by large fleets of interfaces (the platform default is often 8MB). It's called from the thread that
+        /// requests the first operation, and needs to leave enough room for your process_ methods. Defaults to 0 (the platform default).
+        ///
+        /// @return   size_t: the stack size in bytes, or 0 to use the platform default
+        virtual size_t management_thread_stack_size() const { return 0u; }
+
+        /// @brief [[OPTIONAL for interface::raw]] Define the file descriptor that an external event loop can wait on, before calling
+        /// poll_once (see readiness()). When "transactions.poll_only" is true, the process_ methods must not block.
+        ///
+        /// @return   int: the file descriptor, or -1 if there isn't one
+        virtual int readiness_fd() const { return -1; }
+
+        /// @brief [[OPTIONAL]] Define how to attempt a send exactly once without blocking (like with MSG_DONTWAIT), for try_send.
+        /// It's called on the calling thread, but never while a process_ method is running. Set op.status to SUCCESS, to
+        /// status_e::WOULD_BLOCK if it can't be done right now, or to an error.
+        ///
+        /// @return   true: if the attempt was made
+        /// @return   false: if it's not supported, so try_send falls back to a send with a timeout of zero
+        virtual bool process_try_send(send_op &) { return false; }
+
+        /// @brief [[OPTIONAL]] Define how to attempt a receive exactly once without blocking, for try_receive, which works just
+        /// like process_try_send
+        virtual bool process_try_receive(recv_op &) { return false; }
+    };
+
+    template <typename open_opts_type, bool threadsafe>
+    class backend_hooks<open_opts_type, threadsafe, false> : protected wake_process_hook<open_opts_type, threadsafe, false>
+    {
+    protected:
+        // the same hooks as above, where these are the defaults of the optional ones, and the final class must define
+        // process_close, process_open, and process_send_receive (and wake_process if threadsafe)
+        void construct() {}
+        void destruct() {}
+        size_t fds_used() const { return 0u; }
+        std::chrono::nanoseconds idle_thread_timeout() const { return std::chrono::nanoseconds::max(); }
+        size_t management_thread_stack_size() const { return 0u; }
+        int readiness_fd() const { return -1; }
+        bool process_try_send(send_op &) { return false; }
+        bool process_try_receive(recv_op &) { return false; }
+    };
+
+    /// @brief stands in for "interface::abstract" as the base of statically dispatched interfaces
+    struct no_abstract
+    {
+    protected:
+        ~no_abstract() = default;
+    };
+
+    /// @brief an inheritable base class for creating CppTxRx interfaces, that's configured by a set of compile-time policies.
+    /// Any code path that a policy turns off is pruned with "if constexpr", so it costs nothing at runtime.
+    ///
+    /// @tparam   open_opts_type: options type to use when calling "open"
+    /// @tparam   policies_type: an "interface::policy::policies<...>" type (see cpptxrx_policies.h)
+    template <typename open_opts_type, typename policies_type>
+    class factory : protected backend_hooks<open_opts_type, policies_type::sync::threadsafe, !policies_type::dispatch::is_static>,
+                    public std::conditional<policies_type::dispatch::is_static, no_abstract, abstract>::type
     {
     public:
         /// @brief options type to use when calling "open"
         using opts = open_opts_type;
 
-        /// @brief Construct a new cpptxrx interfaces object, and if running in thread safe mode, spools
-        /// up a management thread where all interface interactions will occur, and that all other methods
-        /// will simply dispatch requests to.
-        CPPTXRX_CLASS_NAME()
-        {
-#if CPPTXRX_THREADSAFE
-            // must construct the thread after the full memory initialization, since a race condition can occur if
-            // the thread is created in the initializer list, due to the virtual table not being initialized yet
-            thread_handle = raii_thread(
-                [this]()
-                {
-                    // need to wait until the child class request an operation, otherwise we can't be
-                    // sure that the child class's virtual methods are safe to be called
-                    {
-                        std::unique_lock<std::mutex> lk(m);
-                        cv.wait(lk,
-                                [this]()
-                                {
-                                    return active_ops.is_any(backend::op_bitmasks::ANY_REQUEST);
-                                });
-
-                        // now it's safe to call virtual methods, so construct the child class
-                        std::lock_guard<std::mutex> open_opts_lk(m_open_opts_mutex); // just in case the open opts are modified in construct
-                        construct();
-                    }
-
-                    // now it's safe to allow transactions after construction, so mark as constructed
-                    mark_as_constructed();
+        /// @brief the compile-time policies this interface was built with
+        using policies = policies_type;
 
-                    // transact until a destroy operation is requested
-                    while (single_operation())
-                    {
-                    }
+        /// @brief this factory type, which the IMPORT_CPPTXRX_CTOR macro befriends, so that statically dispatched hooks can be
+        /// called by the factory while staying protected
+        using factory_type = factory;
 
-                    // destruct
-                    {
-                        std::lock_guard<std::mutex> lk(m);
-                        std::lock_guard<std::mutex> open_opts_lk(m_open_opts_mutex); // just in case the open opts are modified in destruct
-                        destruct();
+        /// @brief a constexpr attribute that will be true if the interface is threadsafe
+        /// use is_threadsafe() instead if you want a runtime polymorphic compatible attribute
+        static constexpr bool threadsafe = policies::sync::threadsafe;
+
+        /// @brief constexpr attributes that will be false if the direction policy compiled out sending, or receiving, in which
+        /// case that operation returns status_e::UNSUPPORTED_OP right away
+        static constexpr bool can_send    = policies::direction::can_send;
+        static constexpr bool can_receive = policies::direction::can_receive;
+
+        static constexpr uint64_t default_recv_timeout_ns = policies::timeouts::default_recv_timeout_ns;
+        static constexpr uint64_t default_send_timeout_ns = policies::timeouts::default_send_timeout_ns;
+        static constexpr uint64_t default_open_timeout_ns = policies::timeouts::default_open_timeout_ns;
+        static constexpr uint64_t default_clse_timeout_ns = policies::timeouts::default_clse_timeout_ns;
+
+        /// @brief Construct a new cpptxrx interfaces object. If running in thread safe mode, a management thread
+        /// where all interface interactions will occur (and that all other methods will simply dispatch requests to)
+        /// is spooled up lazily, once the first operation is requested.
+        factory()
+        {
+            // so that the backend measures the operations' end_time against the clock they were set from
+            transactions.read_clock = &clock_policy::now;
 
-                        // notify destruct is complete
-                        active_ops.complete_request(backend::op_category_e::DESTROY);
-                    }
-                    cv.notify_all();
-                });
-#else
             // NOTE: there cannot be a virtual construct() called here, since the child class won't exist yet
             // so instead the child class is required to use IMPORT_CPPTXRX_CTOR_AND_DTOR to call its own construct() method
-#endif
+            // if not threadsafe, or the management thread calls it before its first operation if threadsafe
         }
 
         /// @brief Destroy the cpptxrx interface object by either requesting a destroy from the
         /// threadsafe manager, or just calling destruct() directly if not threadsafe
-        virtual ~CPPTXRX_CLASS_NAME()
+        virtual ~factory()
         {
             destroy();
         }
 
-        CPPTXRX_CLASS_NAME operator=(const CPPTXRX_CLASS_NAME &) = delete;
-        CPPTXRX_CLASS_NAME(const CPPTXRX_CLASS_NAME &)           = delete;
+        factory operator=(const factory &) = delete;
+        factory(const factory &)           = delete;
 
-        void destroy() override
+        void destroy()
         {
-
-#if CPPTXRX_THREADSAFE
+            if constexpr (threadsafe)
             {
-                std::unique_lock<std::mutex> lk(m);
-                if (active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
                 {
-                    // if another thread requested a destruction, just wait for it to finish
-                    cv.wait(lk, [this]()
-                            { return active_ops.is_complete(backend::op_category_e::DESTROY); });
-                    return;
-                }
+                    std::unique_lock<std::mutex> lk(st.m);
+                    if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                    {
+                        // if another thread requested a destruction, just wait for it to finish
+                        wait_policy::wait(lk, st.cv, [this]()
+                                          { return st.active_ops.is_complete(backend::op_category_e::DESTROY); });
+                        return;
+                    }
 
-                active_ops.start_request(backend::op_category_e::DESTROY);
-                wait_for_constructed(lk); // can't call wake_process before constructed
+                    st.active_ops.start_request(backend::op_category_e::DESTROY);
+                    if constexpr (handoff_ops)
+                        st.handoff.destroy_requested.store(true, std::memory_order_seq_cst);
 
-                // the destroy operation, won't actually be able to be started or completed until the mutex is release so it's safe
-                // to check active_ops and then call wake_process now in case any of the process_<open/close/send/receive> methods
-                // needs waking, without worrying about the destructor being called first
-                if (!active_ops.is_complete(interface::backend::op_category_e::DESTROY))
-                    wake_process();
-            }
+                    // if no operation was ever requested, then construct() was never called, so there's nothing to destruct
+                    if (!st.thread_running && !st.active_ops.is_complete(backend::op_category_e::CONSTRUCT))
+                    {
+                        m_open_status = status_e::NOT_OPEN;
+                        publish_open_status();
+                        st.active_ops.complete_request(backend::op_category_e::DESTROY);
+                        lk.unlock();
+                        st.cv.notify_all();
+                        return;
+                    }
+
+                    start_management_thread(); // in case it was never started, or has retired after being idle
+                    wait_for_constructed(lk);  // can't call wake_process before constructed
 
-            cv.notify_all();
+                    // the destroy operation, won't actually be able to be started or completed until the mutex is release so it's safe
+                    // to check active_ops and then call wake_process now in case any of the process_<open/close/send/receive> methods
+                    // needs waking, without worrying about the destructor being called first
+                    if (!st.active_ops.is_complete(interface::backend::op_category_e::DESTROY))
+                        hooks().wake_process();
+                }
+
+                notify_all();
 
+                {
+                    std::unique_lock<std::mutex> lk(st.m);
+                    wait_policy::wait(lk, st.cv, [this]()
+                                      { return st.active_ops.is_complete(backend::op_category_e::DESTROY); });
+                }
+            }
+            else
             {
-                std::unique_lock<std::mutex> lk(m);
-                cv.wait(lk, [this]()
-                        { return active_ops.is_complete(backend::op_category_e::DESTROY); });
+                if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                    return; // don't re-destroy
+                st.active_ops.start_request(backend::op_category_e::DESTROY);
+                single_operation();
+                hooks().destruct();
             }
-#else
-            if (active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
-                return; // don't re-destroy
-            active_ops.start_request(backend::op_category_e::DESTROY);
-            single_operation();
-            destruct();
-#endif
         }
 
         // Various open methods, letting you pick what happens if open is called on an already open connection, and pick whether to reuse settings
-        // NOTE: Detailed documentation is in cpptxrx_abstract.h for all "override" methods (the methods that don't use "opts")
-        //       Only the methods that are not overrides are documented here.
+        // NOTE: Detailed documentation is in cpptxrx_abstract.h for all the methods that match "abstract" (the methods that don't use
+        //       "opts"), which they override unless the dispatch policy is static, so they're declared without "virtual" or "override".
+        //       Only the methods that are not in "abstract" are documented here.
 
-        status_e reopen(std::chrono::steady_clock::time_point end_time) override
+        status_e reopen(std::chrono::steady_clock::time_point end_time)
         {
             open_op op_data{end_time, status_e::IN_PROGRESS};
             internal_open_op all_op_data{&op_data, nullptr, open_behaviour_e::CLOSE_FIRST_IF_ALREADY_OPEN};
@@ -151,15 +293,15 @@ namespace interface
                 return result;
             return op_data.status;
         }
-        status_e reopen(std::chrono::nanoseconds timeout) override
+        status_e reopen(std::chrono::nanoseconds timeout)
         {
-            return reopen(std::chrono::steady_clock::now() + timeout);
+            return reopen(clock_policy::now() + timeout);
         }
-        status_e reopen() override
+        status_e reopen()
         {
-            return reopen(std::chrono::steady_clock::now() + std::chrono::nanoseconds(default_open_timeout_ns));
+            return reopen(clock_policy::now() + std::chrono::nanoseconds(default_open_timeout_ns));
         }
-        status_e open(std::chrono::steady_clock::time_point end_time) override
+        status_e open(std::chrono::steady_clock::time_point end_time)
         {
             open_op op_data{end_time, status_e::IN_PROGRESS};
             internal_open_op all_op_data{&op_data, nullptr, open_behaviour_e::FAIL_TO_OPEN_IF_ALREADY_OPEN};
@@ -168,13 +310,13 @@ namespace interface
                 return result;
             return op_data.status;
         }
-        status_e open(std::chrono::nanoseconds timeout) override
+        status_e open(std::chrono::nanoseconds timeout)
         {
-            return open(std::chrono::steady_clock::now() + timeout);
+            return open(clock_policy::now() + timeout);
         }
-        status_e open() override
+        status_e open()
         {
-            return open(std::chrono::steady_clock::now() + std::chrono::nanoseconds(default_open_timeout_ns));
+            return open(clock_policy::now() + std::chrono::nanoseconds(default_open_timeout_ns));
         }
 
         /// @brief reopen using new settings (reopen will close first if already open - use open if not desired), with a absolute timeout
@@ -200,7 +342,7 @@ namespace interface
         /// @return   status_e: the final status of the operation
         status_e reopen(opts settings, std::chrono::nanoseconds timeout = std::chrono::nanoseconds(default_open_timeout_ns))
         {
-            return reopen(settings, std::chrono::steady_clock::now() + timeout);
+            return reopen(settings, clock_policy::now() + timeout);
         }
 
         /// @brief open using new settings (open will fail if already open - use reopen if not desired), with a
@@ -227,10 +369,10 @@ namespace interface
         /// @return   status_e: the final status of the operation
         status_e open(opts settings, std::chrono::nanoseconds timeout = std::chrono::nanoseconds(default_open_timeout_ns))
         {
-            return open(settings, std::chrono::steady_clock::now() + timeout);
+            return open(settings, clock_policy::now() + timeout);
         }
 
-        status_e close(std::chrono::steady_clock::time_point end_time) override
+        status_e close(std::chrono::steady_clock::time_point end_time)
         {
             close_op op_data{end_time, status_e::IN_PROGRESS};
             status_e result = transact_operation(end_time, backend::op_category_e::CLOSE, &op_data);
@@ -238,65 +380,220 @@ namespace interface
                 return result;
             return op_data.status;
         }
-        status_e close(std::chrono::nanoseconds timeout) override
+        status_e close(std::chrono::nanoseconds timeout)
         {
-            return close(std::chrono::steady_clock::now() + timeout);
+            return close(clock_policy::now() + timeout);
         }
-        status_e close() override
+        status_e close()
         {
-            return close(std::chrono::steady_clock::now() + std::chrono::nanoseconds(default_clse_timeout_ns));
+            return close(clock_policy::now() + std::chrono::nanoseconds(default_clse_timeout_ns));
         }
 
-        using abstract::receive;
-        recv_ret receive(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time) override
+        recv_ret receive(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time)
         {
-            recv_op op_data{end_time, status_e::IN_PROGRESS, data, size};
-            status_e result = transact_operation(end_time, backend::op_category_e::RECEIVE, &op_data);
-            if (result != status_e::SUCCESS)
-                return {result, 0u};
-            return {op_data.status, op_data.returned_recv_size};
+            if constexpr (can_receive)
+            {
+                recv_op op_data{end_time, status_e::IN_PROGRESS, data, size};
+                status_e result = transact_operation(end_time, backend::op_category_e::RECEIVE, &op_data);
+                if (result != status_e::SUCCESS)
+                    return {result, 0u};
+                return {op_data.status, op_data.returned_recv_size, op_data.truncated};
+            }
+            else
+            {
+                (void)data;
+                (void)size;
+                (void)end_time;
+                return {status_e::UNSUPPORTED_OP, 0u};
+            }
+        }
+        recv_ret receive(uint8_t *const data, size_t size, std::chrono::nanoseconds timeout)
+        {
+            return receive(data, size, clock_policy::now() + timeout);
+        }
+        recv_ret receive(uint8_t *const data, size_t size)
+        {
+            return receive(data, size, clock_policy::now() + std::chrono::nanoseconds(default_recv_timeout_ns));
+        }
+
+        /// @brief receives a message into a growable container of bytes (like std::vector<uint8_t>), which backends that know
+        /// the size of the next message first (like udp::socket, which peeks it) grow to fit it, so that it never has to be
+        /// sized for the largest possible message. Backends that don't, receive into its current capacity. Either way, the
+        /// container is resized to the number of bytes received. The container is grown by the backend, which usually means on
+        /// the management thread, so if growing it throws (like std::bad_alloc), the exception is caught there, and the message
+        /// is received truncated into the container's current capacity instead.
+        ///
+        /// @param    output: the container to receive into, with resize(), data(), and capacity() methods
+        /// @param    end_time: when the receive needs to finish by
+        /// @return   recv_ret: the resulting status and size of the receive, and whether it was truncated
+        template <typename container_type>
+        recv_ret receive_into(container_type &output, std::chrono::steady_clock::time_point end_time)
+        {
+            static_assert(sizeof(*output.data()) == 1u, "the container must hold bytes");
+            if constexpr (can_receive)
+            {
+                output.resize(output.capacity());
+                recv_op op_data{end_time, status_e::IN_PROGRESS, reinterpret_cast<uint8_t *>(output.data()), output.size(), 0u,
+                                false, &resize_container<container_type>, &output};
+                status_e result = transact_operation(end_time, backend::op_category_e::RECEIVE, &op_data);
+                if (result != status_e::SUCCESS)
+                    op_data.status = result;
+                output.resize(op_data.status == status_e::SUCCESS ? op_data.returned_recv_size : 0u);
+                return {op_data.status, output.size(), op_data.truncated};
+            }
+            else
+            {
+                (void)end_time;
+                output.resize(0u);
+                return {status_e::UNSUPPORTED_OP, 0u};
+            }
         }
-        recv_ret receive(uint8_t *const data, size_t size, std::chrono::nanoseconds timeout) override
+        template <typename container_type>
+        recv_ret receive_into(container_type &output, std::chrono::nanoseconds timeout)
         {
-            return receive(data, size, std::chrono::steady_clock::now() + timeout);
+            return receive_into(output, clock_policy::now() + timeout);
         }
-        recv_ret receive(uint8_t *const data, size_t size) override
+        template <typename container_type>
+        recv_ret receive_into(container_type &output)
         {
-            return receive(data, size, std::chrono::steady_clock::now() + std::chrono::nanoseconds(default_recv_timeout_ns));
+            return receive_into(output, clock_policy::now() + std::chrono::nanoseconds(default_recv_timeout_ns));
         }
 
-        using abstract::send;
-        status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time) override
+        status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time)
         {
-            send_op op_data{end_time, status_e::IN_PROGRESS, data, size};
-            status_e result = transact_operation(end_time, backend::op_category_e::SEND, &op_data);
-            if (result != status_e::SUCCESS)
-                return result;
-            return op_data.status;
+            return send(data, size, end_time, priority_e::NORMAL);
+        }
+        status_e send(const uint8_t *const data, size_t size, std::chrono::nanoseconds timeout)
+        {
+            return send(data, size, clock_policy::now() + timeout);
         }
-        status_e send(const uint8_t *const data, size_t size, std::chrono::nanoseconds timeout) override
+        status_e send(const uint8_t *const data, size_t size)
         {
-            return send(data, size, std::chrono::steady_clock::now() + timeout);
+            return send(data, size, clock_policy::now() + std::chrono::nanoseconds(default_send_timeout_ns));
         }
-        status_e send(const uint8_t *const data, size_t size) override
+
+        /// @brief sends bytes tagged with a priority class, which picks its lane in the send queue (see policy::priority_send_order),
+        /// and that the backend can map to a network priority
+        ///
+        /// @param    data: the bytes to send
+        /// @param    size: the number of bytes to send
+        /// @param    end_time: when the send needs to finish by
+        /// @param    priority: the priority class of the send
+        /// @return   status_e: the resulting status of the send
+        status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, priority_e priority)
+        {
+            if constexpr (can_send)
+            {
+                send_op op_data{end_time, status_e::IN_PROGRESS, data, size, priority};
+                status_e result = transact_operation(end_time, backend::op_category_e::SEND, &op_data);
+                if (result != status_e::SUCCESS)
+                    return result;
+                return op_data.status;
+            }
+            else
+            {
+                (void)data;
+                (void)size;
+                (void)end_time;
+                (void)priority;
+                return status_e::UNSUPPORTED_OP;
+            }
+        }
+        status_e send(const uint8_t *const data, size_t size, std::chrono::nanoseconds timeout, priority_e priority)
+        {
+            return send(data, size, clock_policy::now() + timeout, priority);
+        }
+
+        // the fixed size array overloads, which are redeclared here since statically dispatched interfaces don't inherit "abstract"
+        template <size_t size>
+        recv_ret receive(uint8_t (&data)[size])
+        {
+            return receive(data, size);
+        }
+        template <size_t size>
+        recv_ret receive(uint8_t (&data)[size], std::chrono::steady_clock::time_point timeout)
+        {
+            return receive(data, size, timeout);
+        }
+        template <size_t size>
+        recv_ret receive(uint8_t (&data)[size], std::chrono::nanoseconds timeout)
+        {
+            return receive(data, size, timeout);
+        }
+        template <size_t size>
+        status_e send(const uint8_t (&data)[size])
+        {
+            return send(data, size);
+        }
+        template <size_t size>
+        status_e send(const uint8_t (&data)[size], std::chrono::steady_clock::time_point timeout)
+        {
+            return send(data, size, timeout);
+        }
+        template <size_t size>
+        status_e send(const uint8_t (&data)[size], std::chrono::nanoseconds timeout)
+        {
+            return send(data, size, timeout);
+        }
+
+        // these override the UNSUPPORTED_OP defaults of abstract's optional try_ methods, unless the dispatch policy is static
+        recv_ret try_receive(uint8_t *const data, size_t size)
         {
-            return send(data, size, std::chrono::steady_clock::now() + std::chrono::nanoseconds(default_send_timeout_ns));
+            if constexpr (can_receive)
+            {
+                recv_op op_data{clock_policy::now(), status_e::IN_PROGRESS, data, size};
+                status_e result = try_operation(backend::op_category_e::RECEIVE, op_data);
+                if (result != status_e::SUCCESS)
+                    return {result, 0u};
+                return {op_data.status, op_data.returned_recv_size, op_data.truncated};
+            }
+            else
+            {
+                (void)data;
+                (void)size;
+                return {status_e::UNSUPPORTED_OP, 0u};
+            }
+        }
+        status_e try_send(const uint8_t *const data, size_t size)
+        {
+            if constexpr (can_send)
+            {
+                send_op op_data{clock_policy::now(), status_e::IN_PROGRESS, data, size};
+                status_e result = try_operation(backend::op_category_e::SEND, op_data);
+                if (result != status_e::SUCCESS)
+                    return result;
+                return op_data.status;
+            }
+            else
+            {
+                (void)data;
+                (void)size;
+                return status_e::UNSUPPORTED_OP;
+            }
         }
 
-        [[nodiscard]] bool is_open() const override
+        [[nodiscard]] bool is_open() const
         {
-#if CPPTXRX_THREADSAFE
-            std::lock_guard<std::mutex> lk(m);
-#endif
-            return m_open_status == status_e::SUCCESS;
+            if constexpr (threadsafe)
+            {
+                // lock-free, reads the copy published by the management thread
+                return st.m_published_is_open.load(std::memory_order_acquire);
+            }
+            else
+                return m_open_status == status_e::SUCCESS;
         }
 
-        [[nodiscard]] status_e open_status() const override
+        [[nodiscard]] status_e open_status() const
         {
-#if CPPTXRX_THREADSAFE
-            std::lock_guard<std::mutex> lk(m);
-#endif
-            return m_open_status;
+            if constexpr (threadsafe)
+            {
+                // lock-free, reads the copy published by the management thread
+                status_e published_status = status_e::NOT_OPEN;
+                st.m_published_open_status.load(published_status);
+                return published_status;
+            }
+            else
+                return m_open_status;
         }
 
         /// @brief Get a copy of the last open opts (even after close is run)
@@ -306,172 +603,769 @@ namespace interface
         /// @return   false: if "open" or "set_open_args" has never been run
         [[nodiscard]] bool get_open_args(opts &out_opts) const
         {
-#if CPPTXRX_THREADSAFE
-            std::lock_guard<std::mutex> open_opts_lk(m_open_opts_mutex);
-#endif
-            if (m_open_opts_initialized)
+            if constexpr (threadsafe)
             {
-                out_opts = m_open_opts;
+                // reads the published copy, so that this never blocks (or is blocked by) the management thread
+                if (!st.m_published_open_opts_valid.load(std::memory_order_acquire))
+                    return false;
+                st.m_published_open_opts.load(out_opts);
                 return true;
             }
-            return false;
+            else
+            {
+                if (st.m_open_opts_initialized)
+                {
+                    out_opts = m_open_opts;
+                    return true;
+                }
+                return false;
+            }
         }
 
         /// @brief Set the open opts to be used the next time open or reopen is called without arguments
         /// in case you want to assign opts but defer the actual opening
         ///
+        /// NOTE: for threadsafe interfaces, the new opts are staged and then applied to m_open_opts by the
+        ///       management thread between operations, so that this never waits for a blocking process_ method
+        ///
         /// @param    new_opts: the new open opts to apply
         template <typename T>
         void set_open_args(T &&new_opts)
         {
-#if CPPTXRX_THREADSAFE
-            std::lock_guard<std::mutex> open_opts_lk(m_open_opts_mutex);
-#endif
-            m_open_opts_initialized = true;
-            m_open_opts             = new_opts;
+            if constexpr (threadsafe)
+            {
+                std::lock_guard<std::mutex> lk(st.m);
+                st.m_open_opts_initialized = true;
+                st.m_pending_open_opts     = std::forward<T>(new_opts);
+                st.m_pending_open_opts_set = true;
+                st.m_published_open_opts.store(st.m_pending_open_opts);
+                st.m_published_open_opts_valid.store(true, std::memory_order_release);
+            }
+            else
+            {
+                st.m_open_opts_initialized = true;
+                m_open_opts                = std::forward<T>(new_opts);
+            }
+        }
+
+        /// @brief reports the threads and file descriptors currently used by the interface, use interface::footprint_of
+        /// to also include the size of the interface's type
+        ///
+        /// @return   footprint_report: the resources currently used by the interface
+        [[nodiscard]] footprint_report footprint() const
+        {
+            footprint_report report{};
+            if constexpr (threadsafe)
+            {
+                std::lock_guard<std::mutex> lk(st.m);
+                report.threads           = st.thread_running ? 1u : 0u;
+                report.thread_stack_size = st.thread_stack_size;
+            }
+            report.fds = hooks().fds_used();
+            return report;
         }
 
-        [[nodiscard]] virtual const char *name() const override { return "unnamed"; }
-        [[nodiscard]] virtual int id() const override { return -1; }
+        /// @brief [[interface::raw only]] posts a send, without performing it, so that it can be driven by an external event loop
+        /// through poll_once, instead of blocking the calling thread
+        ///
+        /// @param    op: the send, which must stay alive until its status is no longer status_e::IN_PROGRESS
+        /// @return   status_e: SUCCESS if posted, WOULD_BLOCK if a send is already in progress, or why it couldn't be posted
+        status_e post_send(send_op &op)
+        {
+            static_assert(!threadsafe, "only raw interfaces can be driven by an external event loop");
+            if constexpr (can_send)
+                return post_operation(backend::op_category_e::SEND, &op, st.send_posted);
+            else
+            {
+                (void)op;
+                return status_e::UNSUPPORTED_OP;
+            }
+        }
 
-        /// @brief a constexpr attribute that will be true if the interface is threadsafe
-        /// use is_threadsafe() instead if you want a runtime polymorphic compatible attribute
-        static constexpr bool threadsafe = CPPTXRX_THREADSAFE;
+        /// @brief [[interface::raw only]] posts a receive, without performing it, so that it can be driven by an external event
+        /// loop through poll_once, instead of blocking the calling thread
+        ///
+        /// @param    op: the receive, which must stay alive until its status is no longer status_e::IN_PROGRESS
+        /// @return   status_e: SUCCESS if posted, WOULD_BLOCK if a receive is already in progress, or why it couldn't be posted
+        status_e post_receive(recv_op &op)
+        {
+            static_assert(!threadsafe, "only raw interfaces can be driven by an external event loop");
+            if constexpr (can_receive)
+                return post_operation(backend::op_category_e::RECEIVE, &op, st.recv_posted);
+            else
+            {
+                (void)op;
+                return status_e::UNSUPPORTED_OP;
+            }
+        }
 
-        virtual bool is_threadsafe() const override { return threadsafe; }
+        /// @brief [[interface::raw only]] runs one non-blocking step of the posted operations, performing any that are ready, and
+        /// failing any that have timed out. Meant to be called by an external event loop, once readiness() says so.
+        ///
+        /// @return   size_t: the number of posted operations that finished (their status is no longer status_e::IN_PROGRESS)
+        size_t poll_once()
+        {
+            static_assert(!threadsafe, "only raw interfaces can be driven by an external event loop");
+            const size_t posted_before = static_cast<size_t>(st.send_posted) + static_cast<size_t>(st.recv_posted);
+            if ((posted_before == 0u && !is_wakeup_due()) || st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                return 0u;
+            transactions.poll_only = true;
+            single_operation();
+            transactions.poll_only = false;
+            return posted_before - (static_cast<size_t>(st.send_posted) + static_cast<size_t>(st.recv_posted));
+        }
 
-    protected:
-        /// @brief [[OPTIONAL]] Define how to construct your interface. Will only be called once.
-        /// Make sure to use this instead of a constructor, if you need one, so that you can call
-        /// virtual methods in this constructor.
-        virtual void construct() {}
+        /// @brief [[interface::raw only]] reports what an external event loop needs to wait for, before calling poll_once
+        ///
+        /// @return   readiness_report: the fd, which readiness to wait for, and the deadline of the posted operations, or of the
+        ///           backend's next wakeup
+        [[nodiscard]] readiness_report readiness() const
+        {
+            static_assert(!threadsafe, "only raw interfaces can be driven by an external event loop");
+            readiness_report report{};
+            report.fd       = hooks().readiness_fd();
+            report.deadline = transactions.next_wakeup;
+            if (st.send_posted)
+            {
+                report.writable = true;
+                report.deadline = std::min(report.deadline, posted_op(transactions.p_send_op, st.requested_ops.p_send_op)->end_time);
+            }
+            if (st.recv_posted)
+            {
+                report.readable = true;
+                report.deadline = std::min(report.deadline, posted_op(transactions.p_recv_op, st.requested_ops.p_recv_op)->end_time);
+            }
+            return report;
+        }
 
-        /// @brief [[OPTIONAL]] Define how to destruct your interface. Will only be called once.
-        virtual void destruct() {}
+        /// @brief [[interface::threadsafe only]] registers a ring of receive buffers, that the management thread then keeps
+        /// receiving into back-to-back whenever the connection is open and the ring has an empty slot, until unregistered. The
+        /// caller consumes the filled slots with the ring's front/wait_front/pop methods, instead of calling receive, which (like
+        /// try_receive) returns status_e::UNSUPPORTED_OP while a ring is registered. Receives that fail aren't put in the ring.
+        ///
+        /// @param    ring: the ring, which must stay alive until unregister_receive_ring returns, or the interface is destroyed. A
+        ///           ring without any slots (like a pooled_receive_ring over a buffer_pool that couldn't be mapped) is rejected
+        ///           with the error code ENOMEM.
+        /// @return   status_e: SUCCESS if registered, WOULD_BLOCK if a ring or a receive is already active, or why it couldn't be
+        status_e register_receive_ring(receive_ring_base &ring)
+        {
+            static_assert(threadsafe && !handoff_ops, "only interfaces with a shared management thread can fill a receive ring");
+            if constexpr (has_receive_ring)
+            {
+                // like a pooled_receive_ring over a buffer_pool that couldn't be mapped
+                if (ring.capacity() == 0u)
+                {
+                    status_e status = status_e::SEE_ERROR_CODE;
+                    status.set_error_code(ENOMEM, "RECEIVE_RING_HAS_NO_SLOTS");
+                    return status;
+                }
+                {
+                    std::unique_lock<std::mutex> lk(st.m);
+                    if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                        return status_e::CANCELED_IN_DESTROY;
+                    if (st.ring.p_ring != nullptr || st.active_ops.is_any(backend::op_category_e::RECEIVE))
+                        return status_e::WOULD_BLOCK;
+                    ring.attach(&wake_for_receive_ring, this);
+                    st.ring.p_ring = &ring;
+
+                    // only an open connection is received from, which always has a running management thread
+                    if (st.thread_running)
+                    {
+                        wait_for_constructed(lk); // can't call wake_process before constructed
+                        hooks().wake_process();
+                    }
+                }
+                notify_all();
+                return status_e::SUCCESS;
+            }
+            else
+            {
+                (void)ring;
+                return status_e::UNSUPPORTED_OP;
+            }
+        }
 
-        /// @brief [[REQUIRED]] Meant to handle the close operation, held in the "transactions.p_close_op"
-        /// variable, which is guaranteed to never nullptr in the method.
-        virtual void process_close() = 0;
+        /// @brief [[interface::threadsafe only]] stops filling the registered receive ring, waiting until the management thread
+        /// is no longer receiving into it, after which its filled slots can still be consumed, and receive can be used again
+        void unregister_receive_ring()
+        {
+            static_assert(threadsafe && !handoff_ops, "only interfaces with a shared management thread can fill a receive ring");
+            if constexpr (has_receive_ring)
+            {
+                std::unique_lock<std::mutex> lk(st.m);
+                st.ring.p_ring = nullptr;
+                if (!st.ring.op_active)
+                    return;
+                hooks().wake_process();
+                wait_policy::wait(lk, st.cv, [this]()
+                                  { return !st.ring.op_active; });
+            }
+        }
 
-        /// @brief [[REQUIRED]] Meant to handle the open operation, held in the "transactions.p_open_op"
-        /// variable, which is guaranteed to never nullptr in the method.
-        virtual void process_open() = 0;
+        [[nodiscard]] const char *name() const { return "unnamed"; }
+        [[nodiscard]] int id() const { return -1; }
 
-        /// @brief [[REQUIRED]] Meant to handle a send operation, a receive operation, or both simultaneously.
-        /// The "transactions.p_send_op", and "transactions.p_receive_op" pointers are not nullptr when
-        /// their operation is requested.
-        virtual void process_send_receive() = 0;
+        bool is_threadsafe() const { return threadsafe; }
 
-#if CPPTXRX_THREADSAFE
-        /// @brief [[only REQUIRED for interface::threadsafe]]
-        /// Used to wake up a process_open/close/send_receive call that is blocking when another operation is requested.
-        /// WARNING!: wake_process is the only "overridden" method that can be called from other threads.
-        /// WARNING!: The wake signal must be sticky (like a eventfd object), since there's no guarantee that wake_process
-        ///           will be called precisely when your process_ method is performing a block or reading the wake signal.
-        virtual void wake_process() = 0;
-#endif
+        /// @brief returns the timeouts used by receive() and send() when they're called without one, set by policy::timeouts
+        std::chrono::nanoseconds default_receive_timeout() const { return std::chrono::nanoseconds(default_recv_timeout_ns); }
+        std::chrono::nanoseconds default_send_timeout() const { return std::chrono::nanoseconds(default_send_timeout_ns); }
 
+        /// @brief implicit conversion to a bool which is true if is_open
+        operator bool() const { return is_open(); }
+
+    protected:
         using transactions_args<opts>::transactions;
         using transactions_args<opts>::m_open_opts;
         using transactions_args<opts>::m_open_status;
 
-    private:
-        enum class open_behaviour_e
+        /// @brief hands finished send/receive operations back to their callers, and picks up new ones (see
+        /// transactions_args::sync_send_receive), which is final so that a backend calling it through its own interface's type
+        /// (like udp::socket_utilities does) resolves it statically, without a virtual call per wakeup
+        bool sync_send_receive() final
         {
-            CLOSE_FIRST_IF_ALREADY_OPEN,
-            FAIL_TO_OPEN_IF_ALREADY_OPEN
-        };
-        backend::op_bitmasks active_ops{};
-        // allow open and reopen to be called immediately without any opts if opts == no_opts
-        bool m_open_opts_initialized{std::is_same<opts, no_opts>::value};
-        opts *p_open_opts{nullptr};
-
-#if CPPTXRX_THREADSAFE
-        mutable std::mutex m{};
-        mutable std::mutex m_open_opts_mutex{};
-        mutable std::condition_variable cv{};
-        raii_thread thread_handle{};
-#endif
+            if constexpr (threadsafe)
+            {
+                // hand back any finished (or timed out) operations, so their callers can return right away
+                end_send_receive_transactions();
 
-        struct internal_open_op
-        {
+                bool keep_waiting = false;
+                {
+                    std::lock_guard<std::mutex> lk(st.m);
+
+                    // opening, closing, and destroying are handled by single_operation, so process_send_receive needs to return first
+                    if (st.active_ops.is_any(backend::op_bitmasks::OPEN_REQUEST | backend::op_bitmasks::CLOSE_REQUEST | backend::op_bitmasks::DESTROY_REQUEST))
+                        return false;
+
+                    accept_send_receive_requests();
+                    keep_waiting = transactions.p_send_op != nullptr || transactions.p_recv_op != nullptr;
+                }
+
+                // notify callers that their transaction was accepted
+                st.cv.notify_all();
+                return keep_waiting;
+            }
+            else
+            {
+                // raw interfaces only ever have the one operation requested by the calling thread
+                return false;
+            }
+        }
+
+    private:
+        using clock_policy    = typename policies::clock;
+        using wait_policy     = typename policies::wait;
+        using dispatch_policy = typename policies::dispatch;
+
+        /// @brief the type the hooks are called through, which is the final class if they're resolved statically
+        using hooks_type = typename std::conditional<dispatch_policy::is_static, typename dispatch_policy::derived, factory>::type;
+
+        inline hooks_type &hooks() noexcept
+        {
+            static_assert(std::is_base_of<factory, hooks_type>::value, "policy::static_dispatch must be given the class that inherits the factory");
+            return static_cast<hooks_type &>(*this);
+        }
+        inline const hooks_type &hooks() const noexcept
+        {
+            static_assert(std::is_base_of<factory, hooks_type>::value, "policy::static_dispatch must be given the class that inherits the factory");
+            return static_cast<const hooks_type &>(*this);
+        }
+
+        /// @brief true if sends and receives are handed to the management thread through handoff slots (see policy::single_caller)
+        static constexpr bool handoff_ops = policies::sync::one_caller_per_op;
+
+        enum class open_behaviour_e
+        {
+            CLOSE_FIRST_IF_ALREADY_OPEN,
+            FAIL_TO_OPEN_IF_ALREADY_OPEN
+        };
+
+        struct internal_open_op
+        {
             open_op *p_open_op_data;
             opts *p_open_arguments;
             open_behaviour_e open_behaviour;
         };
 
-        bool single_operation()
+        /// @brief a send waiting in the send queue, which lives on the stack of the thread that called send
+        struct queued_send
+        {
+            send_op *p_op;
+            bool done;
+            bool try_once; // from try_send, so it's attempted once even though its timeout of zero has already passed
+        };
+
+        /// @brief a fixed capacity first-in-first-out queue, of the sends waiting to be accepted by the management thread
+        class send_queue
+        {
+            queued_send *slots[policies::send_queue_depth] = {};
+            size_t head                                    = 0;
+            size_t count                                   = 0;
+
+        public:
+            [[nodiscard]] inline bool empty() const noexcept { return count == 0u; }
+            [[nodiscard]] inline bool full() const noexcept { return count == policies::send_queue_depth; }
+            [[nodiscard]] inline bool has_room_for(const send_op &) const noexcept { return !full(); }
+            inline void push(queued_send *p_send) noexcept
+            {
+                slots[(head + count) % policies::send_queue_depth] = p_send;
+                count++;
+            }
+            inline queued_send *pop() noexcept
+            {
+                queued_send *p_send = slots[head];
+                head                = (head + 1u) % policies::send_queue_depth;
+                count--;
+                return p_send;
+            }
+            inline void clear() noexcept
+            {
+                head  = 0;
+                count = 0;
+            }
+        };
+
+        /// @brief a fixed capacity queue, of the sends waiting to be accepted by the management thread, ordered earliest deadline
+        /// first (see policy::deadline_send_order)
+        class deadline_send_queue
+        {
+            deadline_heap<queued_send, policies::send_queue_depth, policies::send_order::heap_arity> heap{};
+
+        public:
+            [[nodiscard]] inline bool empty() const noexcept { return heap.empty(); }
+            [[nodiscard]] inline bool has_room_for(const send_op &) const noexcept { return !heap.full(); }
+            inline void push(queued_send *p_send) noexcept { heap.push(p_send, p_send->p_op->end_time); }
+            inline queued_send *pop() noexcept { return heap.pop(); }
+            inline void clear() noexcept { heap.clear(); }
+        };
+
+        /// @brief a high and a normal priority lane of sends, waiting to be accepted by the management thread, where the high
+        /// priority lane is served first, but not more than high_weight times in a row while normal priority sends are waiting
+        /// (see policy::priority_send_order)
+        class priority_send_queue
+        {
+            send_queue high_lane{};
+            send_queue normal_lane{};
+            size_t high_streak = 0u; // the number of high priority sends popped since the last normal priority one
+
+        public:
+            [[nodiscard]] inline bool empty() const noexcept { return high_lane.empty() && normal_lane.empty(); }
+            [[nodiscard]] inline bool has_room_for(const send_op &op) const noexcept
+            {
+                return !(op.priority == priority_e::HIGH ? high_lane : normal_lane).full();
+            }
+            inline void push(queued_send *p_send) noexcept
+            {
+                (p_send->p_op->priority == priority_e::HIGH ? high_lane : normal_lane).push(p_send);
+            }
+            inline queued_send *pop() noexcept
+            {
+                if (!high_lane.empty() && (normal_lane.empty() || high_streak < policies::send_order::high_weight))
+                {
+                    high_streak++;
+                    return high_lane.pop();
+                }
+                high_streak = 0u;
+                return normal_lane.pop();
+            }
+            inline void clear() noexcept
+            {
+                high_lane.clear();
+                normal_lane.clear();
+                high_streak = 0u;
+            }
+        };
+
+        /// @brief stands in for the send queue of interfaces that can't send
+        struct no_send_queue
+        {
+            [[nodiscard]] inline bool empty() const noexcept { return true; }
+            inline void clear() noexcept {}
+        };
+        using send_queue_type = typename std::conditional<
+            can_send,
+            typename std::conditional<(policies::send_order::heap_arity > 0u), deadline_send_queue,
+                                      typename std::conditional<(policies::send_order::high_weight > 0u), priority_send_queue,
+                                                                send_queue>::type>::type,
+            no_send_queue>::type;
+
+        /// @brief true if queued sends that can no longer meet their deadline are failed before reaching the process_ methods
+        /// (see policy::deadline_send_order)
+        static constexpr bool drops_expired_sends = policies::send_order::heap_arity > 0u;
+
+        /// @brief the state used by unsynchronized interfaces
+        struct raw_state
+        {
+            backend::op_bitmasks active_ops{};
+            op_instructions requested_ops{};
+            bool send_posted{false}; // a send posted by post_send is in progress
+            bool recv_posted{false}; // a receive posted by post_receive is in progress
+            // allow open and reopen to be called immediately without any opts if opts == no_opts
+            bool m_open_opts_initialized{std::is_same<opts, no_opts>::value};
+            opts *p_open_opts{nullptr};
+        };
+
+        /// @brief the extra state used by single_caller interfaces, where each group starts on its own cache line since the send
+        /// slot, and the receive slot, are each written by their own caller thread
+        struct handoff_state
+        {
+            alignas(cache_line_size) handoff_slot<send_op> send_slot{};
+            alignas(cache_line_size) handoff_slot<recv_op> recv_slot{};
+
+            // written by both callers, but only when the management thread is asleep or needs waking
+            alignas(cache_line_size) doorbell bell{};
+            std::atomic<uint32_t> callers_waking{0u}; // callers that might be calling wake_process right now
+
+            // read-mostly, only written by the management thread as it starts and stops, and by destroy
+            alignas(cache_line_size) std::atomic<bool> ready{false}; // the thread is running, and construct() has been called
+            std::atomic<bool> destroy_requested{false};
+        };
+        struct no_handoff_state
+        {
+        };
+
+        /// @brief true if the management thread can fill a receive ring (see register_receive_ring)
+        static constexpr bool has_receive_ring = threadsafe && can_receive && !handoff_ops;
+
+        /// @brief the registered receive ring, and the receive into its next empty slot, guarded by "m"
+        struct receive_ring_state
+        {
+            receive_ring_base *p_ring{nullptr};
+            std::optional<recv_op> op{};
+            bool op_active{false}; // "op" is in transactions.p_recv_op, only written by the management thread
+        };
+        struct no_receive_ring_state
+        {
+        };
+
+        /// @brief the state used by interfaces with a management thread. The calling threads and the management thread write
+        /// to it constantly, so it's split into groups that each start on their own cache line to avoid false sharing between them.
+        struct threadsafe_state
+        {
+            // 1) the request/accept/complete handshake, written by callers and the management thread while holding "m"
+            alignas(cache_line_size) mutable std::mutex m{};
+            mutable std::condition_variable cv{};
+            backend::op_bitmasks active_ops{};
+            op_instructions requested_ops{};
+            opts *p_open_opts{nullptr};
+            send_queue_type send_queue{};
+            queued_send *p_active_send{nullptr};
+            bool thread_running{false};
+            bool processing{false}; // the management thread might be running a process_ method, so "m" doesn't exclude it
+
+            // 2) the open opts bookkeeping, written by set_open_args and the management thread while holding "m"
+            // allow open and reopen to be called immediately without any opts if opts == no_opts
+            alignas(cache_line_size) bool m_open_opts_initialized{std::is_same<opts, no_opts>::value};
+            bool m_pending_open_opts_set{false};
+            opts m_pending_open_opts{};
+
+            // 3) copies of the open status and opts, published by the management thread for lock-free reads
+            alignas(cache_line_size) std::atomic<bool> m_published_is_open{false};
+            snapshot<status_e> m_published_open_status{status_e::NOT_OPEN};
+            std::atomic<bool> m_published_open_opts_valid{std::is_same<opts, no_opts>::value};
+            snapshot<opts> m_published_open_opts{};
+
+            // 4) read-mostly state, which is only written when the management thread is started or destroyed
+            alignas(cache_line_size) sized_raii_thread thread_handle{};
+            size_t thread_stack_size{0u};
+
+            // 5) only used by single_caller interfaces
+            typename std::conditional<handoff_ops, handoff_state, no_handoff_state>::type handoff{};
+
+            // 6) only used while a receive ring is registered, and guarded by "m" like group 1
+            typename std::conditional<has_receive_ring, receive_ring_state, no_receive_ring_state>::type ring{};
+        };
+
+        typename std::conditional<threadsafe, threadsafe_state, raw_state>::type st{};
+
+        /// @brief what the management loop should do after a single_operation
+        enum class loop_action_e
+        {
+            KEEP_RUNNING,
+            DESTRUCT,
+            RETIRE_THREAD
+        };
+
+        loop_action_e single_operation()
         {
             // wait for a new transaction instruction
             bool destroyed = false;
+            if constexpr (threadsafe)
             {
-#if CPPTXRX_THREADSAFE
-                std::unique_lock<std::mutex> lk(m);
+                std::unique_lock<std::mutex> lk(st.m);
+                st.processing = false;
+
+                // now that no process_ method is running, publish any open opts it changed
+                publish_open_opts();
+
                 bool no_active_transactions = transactions.p_send_op == nullptr &&
                                               transactions.p_recv_op == nullptr &&
                                               transactions.p_close_op == nullptr &&
                                               transactions.p_open_op == nullptr;
-                if (no_active_transactions && !transactions.idle_in_send_recv)
-                    cv.wait(lk, [this]()
-                            { return active_ops.is_any(backend::op_bitmasks::ANY_REQUEST); });
-#endif
-
-                if (!active_ops.is_any(backend::op_bitmasks::ANY_REQUEST))
+                if (no_active_transactions && !transactions.idle_in_send_recv && !is_wakeup_due())
                 {
-                    // do nothing
-                }
-                else if (active_ops.is_requested(backend::op_category_e::DESTROY))
-                {
-                    active_ops.accept_request(backend::op_category_e::DESTROY);
-                    m_open_status = status_e::NOT_OPEN;
-                    destroyed     = true;
+                    auto has_request = [this]()
+                    {
+                        return st.active_ops.is_any(backend::op_bitmasks::ANY_REQUEST) || !st.send_queue.empty() ||
+                               has_handoff_request() || has_receive_ring_request();
+                    };
+
+                    // only retire the thread if there's nothing open that could need servicing
+                    const auto retire_after = hooks().idle_thread_timeout();
+                    const bool can_retire   = m_open_status != status_e::SUCCESS && retire_after != std::chrono::nanoseconds::max();
+
+                    // but never sleep past the backend's next wakeup, so that it can do its periodic work
+                    const auto timeout = std::min(can_retire ? retire_after : std::chrono::nanoseconds::max(),
+                                                  transactions.duration_until_wakeup());
+                    if (!wait_for_request(lk, timeout, has_request) && !is_wakeup_due() && retire_thread())
+                        return loop_action_e::RETIRE_THREAD;
                 }
-                else
+
+                // and apply any open opts staged by set_open_args, for the same reason
+                if (st.m_pending_open_opts_set)
                 {
-                    if (active_ops.is_requested(backend::op_category_e::SEND))
-                        active_ops.accept_request(backend::op_category_e::SEND);
-                    if (active_ops.is_requested(backend::op_category_e::RECEIVE))
-                        active_ops.accept_request(backend::op_category_e::RECEIVE);
-                    if (active_ops.is_requested(backend::op_category_e::CLOSE))
-                        active_ops.accept_request(backend::op_category_e::CLOSE);
-                    if (active_ops.is_requested(backend::op_category_e::OPEN))
-                    {
-                        // save these new open settings, regardless of if they weill be successful later, to enable retries
-                        if (p_open_opts != &m_open_opts)
-                            set_open_args(*p_open_opts);
-                        active_ops.accept_request(backend::op_category_e::OPEN);
-                    }
+                    m_open_opts                = st.m_pending_open_opts;
+                    st.m_pending_open_opts_set = false;
                 }
+
+                destroyed     = accept_requests();
+                st.processing = true;
             }
+            else
+                destroyed = accept_requests();
 
-#if CPPTXRX_THREADSAFE
-            // notify caller that their transaction was accepted
-            cv.notify_all();
-#endif
+            if constexpr (threadsafe)
+            {
+                // notify caller that their transaction was accepted
+                st.cv.notify_all();
+            }
             if (destroyed)
-                return false;
+                return loop_action_e::DESTRUCT;
 
             // do the transaction(s)
             {
-#if CPPTXRX_THREADSAFE
-                std::lock_guard<std::mutex> open_opts_lk(m_open_opts_mutex);
-#endif
                 // only do one operation at a time in order to quickly notify/wake the calling method
-                // prioritizing closing --> then opening --> and then send/receiving
+                // prioritizing closing --> then opening --> and then send/receiving, where process_send_receive
+                // can keep serving sends and receives using sync_send_receive until an open/close/destroy is requested
                 if (transactions.p_close_op != nullptr)
-                    process_close();
+                    hooks().process_close();
                 else if (transactions.p_open_op != nullptr)
-                    process_open();
-                else if (transactions.p_send_op != nullptr || transactions.p_recv_op != nullptr || transactions.idle_in_send_recv)
-                    process_send_receive();
+                    hooks().process_open();
+                else if (transactions.p_send_op != nullptr || transactions.p_recv_op != nullptr || transactions.idle_in_send_recv ||
+                         is_wakeup_due())
+                {
+                    if (is_wakeup_due())
+                        transactions.next_wakeup = std::chrono::steady_clock::time_point::max(); // the backend re-arms it if it wants to
+                    hooks().process_send_receive();
+                }
+
+                // the process_ methods are allowed to modify the open status, so republish it (the opts are
+                // republished at the start of the next operation, since that needs "m" to be held)
+                publish_open_status();
             }
 
             // check all the transaction return status values, to see if any transactions timed out or finished
-            end_transaction(transactions.p_send_op, backend::op_category_e::SEND);
-            end_transaction(transactions.p_recv_op, backend::op_category_e::RECEIVE);
+            end_send_receive_transactions();
             end_transaction(transactions.p_open_op, backend::op_category_e::OPEN);
             end_transaction(transactions.p_close_op, backend::op_category_e::CLOSE);
-            return true;
+            return loop_action_e::KEEP_RUNNING;
+        }
+
+        /// @brief accepts any requested operations, making them visible to the process_ methods, "m" must be held
+        ///
+        /// @return   true: if a destroy was accepted
+        inline bool accept_requests()
+        {
+            if (st.active_ops.is_requested(backend::op_category_e::DESTROY))
+            {
+                st.active_ops.accept_request(backend::op_category_e::DESTROY);
+                m_open_status = status_e::NOT_OPEN;
+                publish_open_status();
+                if constexpr (handoff_ops)
+                {
+                    st.handoff.ready.store(false, std::memory_order_seq_cst);
+                    if constexpr (can_send)
+                        cancel_handoff(st.handoff.send_slot, transactions.p_send_op);
+                    if constexpr (can_receive)
+                        cancel_handoff(st.handoff.recv_slot, transactions.p_recv_op);
+                }
+                else if constexpr (threadsafe)
+                {
+                    st.send_queue.clear(); // their callers return as soon as they see the destroy
+                    cancel_receive_ring_op();
+                }
+                else
+                {
+                    // nothing will ever poll the posted operations again
+                    cancel_posted(transactions.p_send_op, st.requested_ops.p_send_op, st.send_posted);
+                    cancel_posted(transactions.p_recv_op, st.requested_ops.p_recv_op, st.recv_posted);
+                }
+                return true;
+            }
+
+            accept_send_receive_requests();
+            if (st.active_ops.is_requested(backend::op_category_e::CLOSE))
+            {
+                transactions.p_close_op = st.requested_ops.p_close_op;
+                st.active_ops.accept_request(backend::op_category_e::CLOSE);
+            }
+            if (st.active_ops.is_requested(backend::op_category_e::OPEN))
+            {
+                // save these new open settings, regardless of if they weill be successful later, to enable retries
+                if (st.p_open_opts != &m_open_opts)
+                {
+                    st.m_open_opts_initialized = true;
+                    m_open_opts                = *st.p_open_opts;
+                    publish_open_opts();
+                }
+                transactions.p_open_op = st.requested_ops.p_open_op;
+                st.active_ops.accept_request(backend::op_category_e::OPEN);
+            }
+            return false;
+        }
+
+        /// @brief accepts any requested send/receive operations, making them visible to the process_ methods, "m" must be held
+        inline void accept_send_receive_requests()
+        {
+            if constexpr (handoff_ops)
+            {
+                if constexpr (can_send)
+                    if (transactions.p_send_op == nullptr)
+                        transactions.p_send_op = accept_handoff(st.handoff.send_slot);
+                if constexpr (can_receive)
+                    if (transactions.p_recv_op == nullptr)
+                        transactions.p_recv_op = accept_handoff(st.handoff.recv_slot);
+                return;
+            }
+            else if constexpr (!can_send)
+            {
+                // nothing to accept
+            }
+            else if constexpr (threadsafe)
+            {
+                // move on to the next queued send, failing any that can no longer be sent without handing them to the process_ methods,
+                // where only the deadline order fails expired sends up front, otherwise they're still tried once (so that a send with
+                // a timeout of zero goes out if it can right away), and end_transaction reports their timeout
+                while (transactions.p_send_op == nullptr && !st.send_queue.empty())
+                {
+                    queued_send *p_next = st.send_queue.pop();
+                    if (m_open_status != status_e::SUCCESS)
+                        p_next->p_op->status = status_e::NOT_OPEN;
+                    else if (drops_expired_sends && !p_next->try_once && p_next->p_op->end_time < clock_policy::now())
+                        p_next->p_op->status = status_e::TIMED_OUT;
+                    else
+                    {
+                        st.p_active_send       = p_next;
+                        transactions.p_send_op = p_next->p_op;
+                        break;
+                    }
+                    p_next->done = true;
+                }
+            }
+            else if (st.active_ops.is_requested(backend::op_category_e::SEND))
+            {
+                transactions.p_send_op = st.requested_ops.p_send_op;
+                st.active_ops.accept_request(backend::op_category_e::SEND);
+            }
+            if constexpr (can_receive)
+            {
+                if (st.active_ops.is_requested(backend::op_category_e::RECEIVE))
+                {
+                    transactions.p_recv_op = st.requested_ops.p_recv_op;
+                    st.active_ops.accept_request(backend::op_category_e::RECEIVE);
+                }
+                if constexpr (has_receive_ring)
+                    accept_receive_ring_op();
+            }
+        }
+
+        /// @brief keeps a receive into the registered ring's next empty slot active while open, or cancels it once the ring is
+        /// unregistered, "m" must be held
+        inline void accept_receive_ring_op()
+        {
+            if (st.ring.op_active)
+            {
+                if (st.ring.p_ring == nullptr)
+                    cancel_receive_ring_op();
+                return;
+            }
+            if (!has_receive_ring_request() || transactions.p_recv_op != nullptr)
+                return;
+            st.ring.op.emplace(recv_op{std::chrono::steady_clock::time_point::max(), status_e::IN_PROGRESS,
+                                       st.ring.p_ring->next_empty(), st.ring.p_ring->slot_size()});
+            transactions.p_recv_op = &*st.ring.op;
+            st.ring.op_active      = true;
+        }
+
+        /// @brief stops receiving into the registered ring, without putting anything in it, "m" must be held
+        inline void cancel_receive_ring_op()
+        {
+            if constexpr (has_receive_ring)
+            {
+                if (!st.ring.op_active)
+                    return;
+                transactions.p_recv_op = nullptr;
+                st.ring.op_active      = false;
+            }
+        }
+
+        /// @brief returns true if a receive ring is registered, and has an empty slot to receive into while open, "m" must be held
+        [[nodiscard]] inline bool has_receive_ring_request()
+        {
+            if constexpr (has_receive_ring)
+                return st.ring.p_ring != nullptr && m_open_status == status_e::SUCCESS && st.ring.p_ring->next_empty() != nullptr;
+            else
+                return false;
+        }
+
+        /// @brief returns true if "op" is a receive, that can't be done since a receive ring is registered, "m" must be held
+        [[nodiscard]] inline bool is_receiving_into_ring(backend::op_category_e op) const
+        {
+            if constexpr (has_receive_ring)
+                return op == backend::op_category_e::RECEIVE && st.ring.p_ring != nullptr;
+            else
+            {
+                (void)op;
+                return false;
+            }
+        }
+
+        /// @brief grows a receive_into container, for recv_op::buffer_for, returning nullptr if it threw, since an exception
+        /// escaping the management thread would terminate the process
+        template <typename container_type>
+        static uint8_t *resize_container(void *p_container, size_t size) noexcept
+        {
+            container_type &output = *static_cast<container_type *>(p_container);
+            try
+            {
+                output.resize(size);
+            }
+            catch (...)
+            {
+                return nullptr;
+            }
+            return reinterpret_cast<uint8_t *>(output.data());
+        }
+
+        /// @brief wakes the management thread after a receive ring's consumer returned a slot, while every slot was full
+        static void wake_for_receive_ring(void *p_self)
+        {
+            factory &self = *static_cast<factory *>(p_self);
+            {
+                std::lock_guard<std::mutex> lk(self.st.m);
+                if (self.st.thread_running && self.st.active_ops.is_complete(backend::op_category_e::CONSTRUCT))
+                    self.hooks().wake_process();
+            }
+            self.notify_all();
+        }
+
+        /// @brief ends the send and receive transactions, if they've finished, skipping any the direction policy compiled out
+        inline void end_send_receive_transactions()
+        {
+            if constexpr (can_send)
+                end_transaction(transactions.p_send_op, backend::op_category_e::SEND);
+            if constexpr (can_receive)
+                end_transaction(transactions.p_recv_op, backend::op_category_e::RECEIVE);
         }
 
         void end_transaction(common_op *op_ptr, backend::op_category_e op_ptr_type)
@@ -482,7 +1376,7 @@ namespace interface
             if (op_ptr->status == status_e::IN_PROGRESS)
             {
                 // check for a timeout
-                if (op_ptr->end_time < std::chrono::steady_clock::now())
+                if (op_ptr->end_time < clock_policy::now())
                     op_ptr->status = status_e::TIMED_OUT;
 
                 // check for the user closing the connection, canceling all other normal non-open operations
@@ -498,200 +1392,748 @@ namespace interface
             }
 
             // if not status_e::IN_PROGRESS, then end the transaction
+            if constexpr (has_receive_ring)
             {
-#if CPPTXRX_THREADSAFE
-                std::lock_guard<std::mutex> lk(m);
-#endif
-                switch (op_ptr_type)
+                // the ring's receive has no caller to release, instead what it received is put in the ring
+                if (op_ptr_type == backend::op_category_e::RECEIVE && st.ring.op_active && op_ptr == &*st.ring.op)
                 {
-                case backend::op_category_e::SEND:
+                    {
+                        std::lock_guard<std::mutex> lk(st.m);
+                        if (st.ring.p_ring != nullptr && st.ring.op->status == status_e::SUCCESS)
+                            st.ring.p_ring->fill(st.ring.op->returned_recv_size, st.ring.op->truncated);
+                        cancel_receive_ring_op();
+                    }
+                    st.cv.notify_all(); // in case unregister_receive_ring is waiting
+                    return;
+                }
+            }
+            if constexpr (handoff_ops)
+            {
+                // handoff slots are released without "m"
+                if (op_ptr_type == backend::op_category_e::SEND || op_ptr_type == backend::op_category_e::RECEIVE)
                 {
-                    transactions.p_send_op = nullptr;
-                    break;
+                    complete_transaction(op_ptr_type);
+                    return;
                 }
-                case backend::op_category_e::RECEIVE:
+            }
+            if constexpr (threadsafe)
+            {
                 {
-                    transactions.p_recv_op = nullptr;
-                    break;
+                    std::lock_guard<std::mutex> lk(st.m);
+                    complete_transaction(op_ptr_type);
                 }
-                case backend::op_category_e::OPEN:
+                st.cv.notify_all();
+            }
+            else
+                complete_transaction(op_ptr_type);
+        }
+
+        /// @brief releases a finished transaction back to its caller, "m" must be held
+        inline void complete_transaction(backend::op_category_e op_ptr_type)
+        {
+            switch (op_ptr_type)
+            {
+            case backend::op_category_e::SEND:
+            {
+                transactions.p_send_op = nullptr;
+                if constexpr (handoff_ops)
                 {
-                    m_open_status          = transactions.p_open_op->status;
-                    transactions.p_open_op = nullptr;
-                    p_open_opts            = nullptr;
-                    break;
+                    st.handoff.send_slot.complete();
+                    return;
                 }
-                case backend::op_category_e::CLOSE:
+                else if constexpr (threadsafe)
                 {
-                    if (transactions.p_close_op->status == status_e::SUCCESS)
-                        m_open_status = status_e::NOT_OPEN;
-                    transactions.p_close_op = nullptr;
-                    break;
+                    // queued sends are released individually, instead of through active_ops
+                    st.p_active_send->done = true;
+                    st.p_active_send       = nullptr;
+                    return;
+                }
+                else if (st.send_posted)
+                {
+                    // posted sends have no caller waiting to end them, so they're released right away
+                    st.send_posted = false;
+                    st.active_ops.end_request(op_ptr_type);
+                    return;
                 }
-                case backend::op_category_e::CONSTRUCT:
-                    // fallthrough
-                case backend::op_category_e::DESTROY:
-                    // fallthrough
-                default:
-                    break;
+                break;
+            }
+            case backend::op_category_e::RECEIVE:
+            {
+                transactions.p_recv_op = nullptr;
+                if constexpr (handoff_ops)
+                {
+                    st.handoff.recv_slot.complete();
+                    return;
                 }
-                active_ops.complete_request(op_ptr_type);
+                else if constexpr (!threadsafe)
+                {
+                    if (st.recv_posted)
+                    {
+                        st.recv_posted = false;
+                        st.active_ops.end_request(op_ptr_type);
+                        return;
+                    }
+                }
+                break;
             }
-#if CPPTXRX_THREADSAFE
-            cv.notify_all();
-#endif
+            case backend::op_category_e::OPEN:
+            {
+                m_open_status          = transactions.p_open_op->status;
+                transactions.p_open_op = nullptr;
+                st.p_open_opts         = nullptr;
+                publish_open_state();
+                break;
+            }
+            case backend::op_category_e::CLOSE:
+            {
+                if (transactions.p_close_op->status == status_e::SUCCESS)
+                    m_open_status = status_e::NOT_OPEN;
+                transactions.p_close_op = nullptr;
+                publish_open_status();
+                break;
+            }
+            case backend::op_category_e::CONSTRUCT:
+                // fallthrough
+            case backend::op_category_e::DESTROY:
+                // fallthrough
+            default:
+                break;
+            }
+            st.active_ops.complete_request(op_ptr_type);
+        }
+
+        /// @brief publishes a copy of m_open_status for lock-free reads, only called from the management thread
+        inline void publish_open_status()
+        {
+            if constexpr (threadsafe)
+            {
+                st.m_published_open_status.store(m_open_status);
+                st.m_published_is_open.store(m_open_status == status_e::SUCCESS, std::memory_order_release);
+            }
+        }
+
+        /// @brief publishes a copy of m_open_opts for lock-free reads, only called from the management thread with "m" held
+        inline void publish_open_opts()
+        {
+            if constexpr (threadsafe)
+            {
+                // staged opts were already published by set_open_args, so don't overwrite them with older ones
+                if (!st.m_open_opts_initialized || st.m_pending_open_opts_set)
+                    return;
+                st.m_published_open_opts.store(m_open_opts);
+                st.m_published_open_opts_valid.store(true, std::memory_order_release);
+            }
+        }
+
+        /// @brief publishes copies of both the open status and opts, only called from the management thread with "m" held
+        inline void publish_open_state()
+        {
+            publish_open_status();
+            publish_open_opts();
+        }
+
+        /// @brief starts the management thread if it isn't already running, "m" must be held
+        inline void start_management_thread()
+        {
+            if (st.thread_running)
+                return;
+
+            // if the thread retired after being idle, it will have already released "m" and be exiting, so joining is quick
+            if (st.thread_handle.joinable())
+                st.thread_handle.join();
+
+            st.thread_running    = true;
+            st.thread_stack_size = hooks().management_thread_stack_size();
+            st.thread_handle     = sized_raii_thread(
+                st.thread_stack_size,
+                [this]()
+                {
+                    // this is only started once an operation is requested, by which point the child class's virtual
+                    // methods are safe to be called, so construct the child class the first time it's started
+                    {
+                        std::lock_guard<std::mutex> lk(st.m);
+                        if (!st.active_ops.is_complete(backend::op_category_e::CONSTRUCT))
+                        {
+                            hooks().construct();
+                            publish_open_state();
+
+                            // now it's safe to allow transactions after construction, so mark as constructed
+                            st.active_ops.complete_request(backend::op_category_e::CONSTRUCT);
+                        }
+                        if constexpr (handoff_ops)
+                            st.handoff.ready.store(true, std::memory_order_seq_cst);
+                    }
+                    st.cv.notify_all();
+
+                    // transact until a destroy operation is requested, or the thread is idle for long enough to retire
+                    loop_action_e action = loop_action_e::KEEP_RUNNING;
+                    while (action == loop_action_e::KEEP_RUNNING)
+                        action = single_operation();
+                    if (action == loop_action_e::RETIRE_THREAD)
+                        return;
+
+                    // wait for any caller that saw the interface as ready to finish waking it, before wake_process's resources are destructed
+                    if constexpr (handoff_ops)
+                        while (st.handoff.callers_waking.load(std::memory_order_seq_cst) != 0u)
+                            std::this_thread::yield();
+
+                    // destruct
+                    {
+                        std::lock_guard<std::mutex> lk(st.m);
+                        hooks().destruct();
+                        publish_open_state();
+
+                        // notify destruct is complete
+                        st.active_ops.complete_request(backend::op_category_e::DESTROY);
+                    }
+                    st.cv.notify_all();
+                });
         }
 
-#if CPPTXRX_THREADSAFE
-        inline void mark_as_constructed()
+        /// @brief notifies both the callers waiting on "cv", and a management thread that's asleep waiting for a request
+        inline void notify_all()
         {
+            st.cv.notify_all();
+            if constexpr (handoff_ops)
+                st.handoff.bell.ring();
+        }
+
+        /// @brief waits for a request while the management thread is idle, "m" must be held
+        ///
+        /// @return   false: if the timeout passed first
+        template <typename pred_type>
+        inline bool wait_for_request(std::unique_lock<std::mutex> &lk, std::chrono::nanoseconds timeout, pred_type pred)
+        {
+            if constexpr (handoff_ops)
+                return st.handoff.bell.wait_for(lk, timeout, pred);
+            else
             {
-                std::unique_lock<std::mutex> lk(m);
-                active_ops.complete_request(backend::op_category_e::CONSTRUCT);
+                // saturate the deadline, since adding a long idle_thread_timeout to the current time could overflow
+                const auto now = clock_policy::now();
+                if (timeout >= std::chrono::steady_clock::time_point::max() - now)
+                {
+                    st.cv.wait(lk, pred);
+                    return true;
+                }
+                return st.cv.wait_until(lk, now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout), pred);
             }
-            cv.notify_all();
         }
+
+        /// @brief marks the management thread as no longer running, after it's been idle for too long, "m" must be held
+        ///
+        /// @return   false: if a handoff raced with the decision to retire, so the thread needs to keep running
+        inline bool retire_thread()
+        {
+            if constexpr (handoff_ops)
+            {
+                // callers check "ready" after posting to their slot, and then start a new thread if needed, so
+                // re-check the slots after clearing "ready" in case one was posted in between
+                st.handoff.ready.store(false, std::memory_order_seq_cst);
+                if (has_handoff_request())
+                {
+                    st.handoff.ready.store(true, std::memory_order_seq_cst);
+                    return false;
+                }
+            }
+            st.thread_running = false;
+            return true;
+        }
+
+        /// @brief returns true if a caller has posted an operation to a handoff slot that hasn't been accepted yet
+        [[nodiscard]] inline bool has_handoff_request() const
+        {
+            if constexpr (handoff_ops)
+                return (can_send && st.handoff.send_slot.is_requested()) || (can_receive && st.handoff.recv_slot.is_requested());
+            else
+                return false;
+        }
+
+        /// @brief accepts an operation from a handoff slot, failing it right away if it can no longer be processed
+        ///
+        /// @return   op_type*: the operation to hand to the process_ methods, or nullptr if there isn't one
+        template <typename op_type>
+        inline op_type *accept_handoff(handoff_slot<op_type> &slot)
+        {
+            op_type *p_op = slot.accept();
+            if (p_op == nullptr)
+                return nullptr;
+            if (m_open_status != status_e::SUCCESS)
+                p_op->status = status_e::NOT_OPEN;
+            else if (p_op->end_time < clock_policy::now())
+                p_op->status = status_e::TIMED_OUT;
+            else
+                return p_op;
+            slot.complete();
+            return nullptr;
+        }
+
+        /// @brief cancels both an accepted operation, and any newly posted one, in a handoff slot during a destroy
+        template <typename op_type>
+        inline void cancel_handoff(handoff_slot<op_type> &slot, op_type *&p_accepted_op)
+        {
+            if (p_accepted_op == nullptr)
+                p_accepted_op = slot.accept();
+            if (p_accepted_op == nullptr)
+                return;
+            if (p_accepted_op->status == status_e::IN_PROGRESS)
+                p_accepted_op->status = status_e::CANCELED_IN_DESTROY;
+            p_accepted_op = nullptr;
+            slot.complete();
+        }
+
         inline void wait_for_constructed(std::unique_lock<std::mutex> &lk)
         {
-            if (!active_ops.is_complete(backend::op_category_e::CONSTRUCT))
+            if (!st.active_ops.is_complete(backend::op_category_e::CONSTRUCT))
             {
                 lk.unlock();
-                cv.notify_all();
+                notify_all();
                 lk.lock();
-                cv.wait(lk, [&]() { // don't allow any operations if not constructed
-                    return active_ops.is_complete(backend::op_category_e::CONSTRUCT);
+                st.cv.wait(lk, [&]() { // don't allow any operations if not constructed
+                    return st.active_ops.is_complete(backend::op_category_e::CONSTRUCT);
                 });
             }
         }
-#endif
+
+        /// @brief checks that an operation can be requested, and then requests it, "m" must be held
+        status_e request_operation(backend::op_category_e op, void *op_src_data)
+        {
+            if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                return status_e::CANCELED_IN_DESTROY;
+
+            // mark the operation request as started and populate any needed op data
+            switch (op)
+            {
+            case backend::op_category_e::RECEIVE:
+            {
+                if (m_open_status != status_e::SUCCESS)
+                    return status_e::NOT_OPEN;
+                st.requested_ops.p_recv_op = reinterpret_cast<recv_op *>(op_src_data);
+                break;
+            }
+            case backend::op_category_e::SEND:
+            {
+                if (m_open_status != status_e::SUCCESS)
+                    return status_e::NOT_OPEN;
+                st.requested_ops.p_send_op = reinterpret_cast<send_op *>(op_src_data);
+                break;
+            }
+            case backend::op_category_e::CLOSE:
+            {
+                if (m_open_status != status_e::SUCCESS)
+                    return status_e::NOT_OPEN;
+                st.requested_ops.p_close_op = reinterpret_cast<close_op *>(op_src_data);
+                break;
+            }
+            case backend::op_category_e::OPEN:
+            {
+                internal_open_op &op_src_data_ref = *reinterpret_cast<internal_open_op *>(op_src_data);
+                if (op_src_data_ref.open_behaviour == open_behaviour_e::FAIL_TO_OPEN_IF_ALREADY_OPEN && m_open_status == status_e::SUCCESS)
+                    return status_e::FAILED_ALREADY_OPEN;
+
+                // if no options were specified, try and re-use the last options
+                if (op_src_data_ref.p_open_arguments == nullptr)
+                {
+                    // if no options can be re-used, fail immediately with an error so that no nullptr p_open_opts can be passed in
+                    if (!st.m_open_opts_initialized)
+                        return status_e::NO_PRIOR_OPEN_ARGS;
+                    st.p_open_opts = &m_open_opts;
+                }
+                else
+                    st.p_open_opts = op_src_data_ref.p_open_arguments;
+                st.requested_ops.p_open_op = op_src_data_ref.p_open_op_data;
+                break;
+            }
+            case backend::op_category_e::CONSTRUCT:
+                // fallthrough
+            case backend::op_category_e::DESTROY:
+                // fallthrough
+            default:
+                return status_e::CANCELED_IN_DESTROY;
+            }
+
+            st.active_ops.start_request(op);
+            return status_e::SUCCESS;
+        }
+
         status_e transact_operation(std::chrono::steady_clock::time_point end_time, backend::op_category_e op, void *op_src_data)
         {
-            // wait for a transaction request slot to be available
+            if constexpr (!threadsafe)
             {
-#if CPPTXRX_THREADSAFE
-                std::unique_lock<std::mutex> lk(m);
-                const bool timed_out = !cv.wait_until(
-                    lk, end_time,
-                    [&]()
-                    {
-                        // don't allow any other transactions if we're in the
-                        // process of destructing
-                        if (active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
-                            return true;
+                // an operation posted by post_send/post_receive is still in progress
+                if (st.active_ops.is_any(op))
+                    return status_e::WOULD_BLOCK;
 
-                        // don't bother waiting for a send/receive/close if the socket isn't even open
-                        if (m_open_status != status_e::SUCCESS && (op == backend::op_category_e::RECEIVE ||
-                                                                   op == backend::op_category_e::SEND ||
-                                                                   op == backend::op_category_e::CLOSE))
-                            return true;
+                status_e result = request_operation(op, op_src_data);
+                if (result != status_e::SUCCESS)
+                    return result;
 
-                        // keep waiting if in the process of opening, or closing
-                        if (active_ops.is_any(backend::op_bitmasks::ANY_OPEN_OR_CLOSE))
-                            return false;
+                // keep going until the operation finishes, since a posted operation finishing can also end the wait
+                do
+                    single_operation();
+                while (st.active_ops.is_accepted(op) && !st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY));
 
-                        // stop waiting if there is not already an operation pending
-                        // of the requested op category
-                        return !active_ops.is_any(op);
-                    });
-                if (timed_out)
-                    return status_e::TIMED_OUT;
-#endif
-                if (active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
                     return status_e::CANCELED_IN_DESTROY;
-
-                // mark the operation request as started and populate any needed op data
-                switch (op)
+                st.active_ops.end_request(op);
+                return status_e::SUCCESS;
+            }
+            else
+            {
+                if constexpr (handoff_ops)
                 {
-                case backend::op_category_e::RECEIVE:
+                    if constexpr (can_send)
+                        if (op == backend::op_category_e::SEND)
+                            return transact_handoff(st.handoff.send_slot, *reinterpret_cast<send_op *>(op_src_data));
+                    if constexpr (can_receive)
+                        if (op == backend::op_category_e::RECEIVE)
+                            return transact_handoff(st.handoff.recv_slot, *reinterpret_cast<recv_op *>(op_src_data));
+                }
+                else if constexpr (can_send)
                 {
-                    if (m_open_status != status_e::SUCCESS)
-                        return status_e::NOT_OPEN;
-                    transactions.p_recv_op = reinterpret_cast<recv_op *>(op_src_data);
-                    break;
+                    if (op == backend::op_category_e::SEND)
+                        return transact_queued_send(end_time, *reinterpret_cast<send_op *>(op_src_data));
                 }
-                case backend::op_category_e::SEND:
+
+                // wait for a transaction request slot to be available
                 {
-                    if (m_open_status != status_e::SUCCESS)
-                        return status_e::NOT_OPEN;
-                    transactions.p_send_op = reinterpret_cast<send_op *>(op_src_data);
-                    break;
+                    std::unique_lock<std::mutex> lk(st.m);
+                    const bool timed_out = !wait_policy::wait_until(
+                        lk, st.cv, end_time,
+                        [&]()
+                        {
+                            // don't allow any other transactions if we're in the
+                            // process of destructing
+                            if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                                return true;
+
+                            // don't bother waiting for a send/receive/close if the socket isn't even open
+                            if (m_open_status != status_e::SUCCESS && (op == backend::op_category_e::RECEIVE ||
+                                                                       op == backend::op_category_e::CLOSE))
+                                return true;
+
+                            // keep waiting if in the process of opening, or closing
+                            if (st.active_ops.is_any(backend::op_bitmasks::ANY_OPEN_OR_CLOSE))
+                                return false;
+
+                            // stop waiting if there is not already an operation pending
+                            // of the requested op category
+                            return !st.active_ops.is_any(op);
+                        });
+                    if (timed_out)
+                        return status_e::TIMED_OUT;
+                    if (is_receiving_into_ring(op))
+                        return status_e::UNSUPPORTED_OP;
+
+                    status_e result = request_operation(op, op_src_data);
+                    if (result != status_e::SUCCESS)
+                        return result;
+
+                    start_management_thread(); // in case it was never started, or has retired after being idle
+                    wait_for_constructed(lk);  // can't call wake_process before constructed
+
+                    // wake/notify the operations loop that there is a new operation request to process
+                    hooks().wake_process();
                 }
-                case backend::op_category_e::CLOSE:
+                notify_all();
+
+                // wait for the operation loop to respond with a completion status and release the op request
+                {
+                    std::unique_lock<std::mutex> lk(st.m);
+                    wait_policy::wait(lk, st.cv,
+                                      [this, op]()
+                                      {
+                                          return st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY) ||
+                                                 st.active_ops.is_complete(op);
+                                      });
+                    if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                        return status_e::CANCELED_IN_DESTROY;
+                    st.active_ops.end_request(op);
+                }
+                st.cv.notify_all();
+                return status_e::SUCCESS;
+            }
+        }
+
+        /// @brief returns true if the backend's next_wakeup has passed, so process_send_receive needs to be called
+        inline bool is_wakeup_due() const
+        {
+            return transactions.is_wakeup_due(clock_policy::now());
+        }
+
+        /// @brief attempts an operation once without blocking (see try_send/try_receive), directly on the calling thread if the
+        /// backend supports it, and the management thread isn't running a process_ method, or otherwise by handing it to the
+        /// process_ methods with a timeout of zero, which still attempt it once
+        template <typename op_type>
+        status_e try_operation(backend::op_category_e op, op_type &op_data)
+        {
+            if constexpr (threadsafe)
+            {
+                // while "m" is held, an idle management thread can't start a process_ method, so the attempt can't overlap one
+                std::lock_guard<std::mutex> lk(st.m);
+                if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                    return status_e::CANCELED_IN_DESTROY;
+                if (is_receiving_into_ring(op))
+                    return status_e::UNSUPPORTED_OP;
+                if (!st.processing && st.active_ops.is_complete(backend::op_category_e::CONSTRUCT))
                 {
                     if (m_open_status != status_e::SUCCESS)
                         return status_e::NOT_OPEN;
-                    transactions.p_close_op = reinterpret_cast<close_op *>(op_src_data);
-                    break;
+                    if (try_directly(op_data))
+                    {
+                        publish_open_status(); // in case the attempt failed and closed the connection
+                        return status_e::SUCCESS;
+                    }
                 }
-                case backend::op_category_e::OPEN:
-                {
-                    internal_open_op &op_src_data_ref = *reinterpret_cast<internal_open_op *>(op_src_data);
-                    if (op_src_data_ref.open_behaviour == open_behaviour_e::FAIL_TO_OPEN_IF_ALREADY_OPEN && m_open_status == status_e::SUCCESS)
-                        return status_e::FAILED_ALREADY_OPEN;
+            }
+            else
+            {
+                if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                    return status_e::CANCELED_IN_DESTROY;
+                if (m_open_status != status_e::SUCCESS)
+                    return status_e::NOT_OPEN;
+                if (!st.active_ops.is_any(op) && try_directly(op_data))
+                    return status_e::SUCCESS;
+            }
+
+            // fall back to an operation that times out right away, where timing out means it would have blocked
+            status_e result = transact_once(op_data);
+            if (result == status_e::TIMED_OUT)
+                return status_e::WOULD_BLOCK;
+            if (op_data.status == status_e::TIMED_OUT)
+                op_data.status = status_e::WOULD_BLOCK;
+            return result;
+        }
+
+        inline bool try_directly(send_op &op_data) { return hooks().process_try_send(op_data); }
+        inline bool try_directly(recv_op &op_data) { return hooks().process_try_receive(op_data); }
+
+        /// @brief hands a try_ operation to the process_ methods, where a queued send is still attempted once, even though its
+        /// timeout of zero will have passed by the time it's accepted
+        inline status_e transact_once(send_op &op_data)
+        {
+            if constexpr (threadsafe && !handoff_ops)
+                return transact_queued_send(op_data.end_time, op_data, true);
+            else
+                return transact_operation(op_data.end_time, backend::op_category_e::SEND, &op_data);
+        }
+        inline status_e transact_once(recv_op &op_data)
+        {
+            return transact_operation(op_data.end_time, backend::op_category_e::RECEIVE, &op_data);
+        }
+
+        /// @brief posts an operation to be driven by poll_once (see post_send/post_receive)
+        status_e post_operation(backend::op_category_e op, void *op_src_data, bool &posted)
+        {
+            if (st.active_ops.is_any(op))
+                return status_e::WOULD_BLOCK;
+            status_e result = request_operation(op, op_src_data);
+            if (result == status_e::SUCCESS)
+                posted = true;
+            return result;
+        }
+
+        /// @brief returns the posted operation, whether it's been accepted yet or not
+        template <typename op_type>
+        static inline op_type *posted_op(op_type *p_accepted_op, op_type *p_requested_op) noexcept
+        {
+            return p_accepted_op != nullptr ? p_accepted_op : p_requested_op;
+        }
 
-                    // if no options were specified, try and re-use the last options
-                    if (op_src_data_ref.p_open_arguments == nullptr)
+        /// @brief cancels a posted operation during a destroy
+        template <typename op_type>
+        inline void cancel_posted(op_type *&p_accepted_op, op_type *p_requested_op, bool &posted)
+        {
+            if (!posted)
+                return;
+            op_type *p_op = posted_op(p_accepted_op, p_requested_op);
+            if (p_op->status == status_e::IN_PROGRESS)
+                p_op->status = status_e::CANCELED_IN_DESTROY;
+            p_accepted_op = nullptr;
+            posted        = false;
+        }
+
+        /// @brief queues a send for the management thread, and waits for it to be released, so that the management thread
+        /// can move straight on to the next send (see policy::policies::send_queue_depth), "m" must not be held
+        ///
+        /// @param    try_once: true if it's from try_send, so that it's attempted even if it's already expired when accepted
+        status_e transact_queued_send(std::chrono::steady_clock::time_point end_time, send_op &op_data, bool try_once = false)
+        {
+            queued_send entry{&op_data, false, try_once};
+
+            // wait for room in the send queue
+            {
+                std::unique_lock<std::mutex> lk(st.m);
+                const bool timed_out = !wait_policy::wait_until(
+                    lk, st.cv, end_time,
+                    [this, &op_data]()
                     {
-                        // if no options can be re-used, fail immediately with an error so that no nullptr p_open_opts can be passed in
-                        {
-#if CPPTXRX_THREADSAFE
-                            std::lock_guard<std::mutex> open_opts_lk(m_open_opts_mutex);
-#endif
-                            if (!m_open_opts_initialized)
-                                return status_e::NO_PRIOR_OPEN_ARGS;
-                        }
-                        p_open_opts = &m_open_opts;
-                    }
-                    else
-                        p_open_opts = op_src_data_ref.p_open_arguments;
-                    transactions.p_open_op = op_src_data_ref.p_open_op_data;
-                    break;
-                }
-                case backend::op_category_e::CONSTRUCT:
-                    // fallthrough
-                case backend::op_category_e::DESTROY:
-                    // fallthrough
-                default:
+                        // don't bother waiting if destructing, or the socket isn't even open
+                        if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY) || m_open_status != status_e::SUCCESS)
+                            return true;
+
+                        // keep waiting if in the process of opening, or closing
+                        if (st.active_ops.is_any(backend::op_bitmasks::ANY_OPEN_OR_CLOSE))
+                            return false;
+
+                        return st.send_queue.has_room_for(op_data);
+                    });
+                if (timed_out)
+                    return status_e::TIMED_OUT;
+                if (st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
                     return status_e::CANCELED_IN_DESTROY;
-                }
+                if (m_open_status != status_e::SUCCESS)
+                    return status_e::NOT_OPEN;
 
-                active_ops.start_request(op);
-#if CPPTXRX_THREADSAFE
-                wait_for_constructed(lk); // can't call wake_process before constructed
+                st.send_queue.push(&entry);
 
-                // wake/notify the operations loop that there is a new operation request to process
-                wake_process();
-#endif
-            }
+                start_management_thread(); // in case it was never started, or has retired after being idle
+                wait_for_constructed(lk);  // can't call wake_process before constructed
 
-#if CPPTXRX_THREADSAFE
-            cv.notify_all();
-#else
-            single_operation();
-#endif
+                // wake/notify the operations loop that there is a new send to process
+                hooks().wake_process();
+            }
+            st.cv.notify_all();
 
-            // wait for the operation loop to respond with a completion status and release the op request
+            // wait for the operation loop to release the send, which only ever happens with "m" held
             {
-#if CPPTXRX_THREADSAFE
-                std::unique_lock<std::mutex> lk(m);
-                cv.wait(lk,
-                        [this, op]()
-                        {
-                            return active_ops.is_any(backend::op_bitmasks::ANY_DESTROY) ||
-                                   active_ops.is_complete(op);
-                        });
-#endif
-                if (active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                std::unique_lock<std::mutex> lk(st.m);
+                wait_policy::wait(lk, st.cv,
+                                  [this, &entry]()
+                                  {
+                                      return entry.done || st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY);
+                                  });
+                if (!entry.done)
                     return status_e::CANCELED_IN_DESTROY;
-                active_ops.end_request(op);
             }
-#if CPPTXRX_THREADSAFE
-            cv.notify_all();
-#endif
+            return status_e::SUCCESS;
+        }
+
+        /// @brief hands a send or receive to the management thread through its handoff slot, without locking "m" unless the
+        /// management thread needs to be started, and waits for it to be handed back (see policy::single_caller)
+        template <typename op_type>
+        status_e transact_handoff(handoff_slot<op_type> &slot, op_type &op_data)
+        {
+            slot.begin_call();
+            const status_e result = handoff_operation(slot, op_data);
+            slot.end_call();
+            return result;
+        }
+
+        template <typename op_type>
+        status_e handoff_operation(handoff_slot<op_type> &slot, op_type &op_data)
+        {
+            if (st.handoff.destroy_requested.load(std::memory_order_acquire))
+                return status_e::CANCELED_IN_DESTROY;
+            if (!st.m_published_is_open.load(std::memory_order_acquire))
+                return status_e::NOT_OPEN;
+
+            slot.post(&op_data);
+
+            // the management thread sweeps the slots once it accepts a destroy, so only wait on a slot that was posted before
+            // the destroy was requested (or that was already accepted anyway)
+            if (st.handoff.destroy_requested.load(std::memory_order_seq_cst) && slot.withdraw())
+                return status_e::CANCELED_IN_DESTROY;
+
+            if (!st.handoff.ready.load(std::memory_order_seq_cst))
+            {
+                // the management thread was never started, or has retired after being idle
+                std::unique_lock<std::mutex> lk(st.m);
+                if (!st.active_ops.is_any(backend::op_bitmasks::ANY_DESTROY))
+                {
+                    start_management_thread();
+                    wait_for_constructed(lk);
+                }
+            }
+
+            // only a management thread that's awake could be blocked in a process_ method, and need waking
+            if (!st.handoff.bell.ring())
+            {
+                st.handoff.callers_waking.fetch_add(1u, std::memory_order_seq_cst);
+                if (!st.handoff.destroy_requested.load(std::memory_order_seq_cst))
+                    hooks().wake_process();
+                st.handoff.callers_waking.fetch_sub(1u, std::memory_order_seq_cst);
+            }
+
+            if (!slot.wait_done(op_data.end_time, wait_policy::spins))
+            {
+                if (slot.withdraw())
+                    return status_e::TIMED_OUT;
+
+                // it was accepted just in time, so the management thread will hand it back once it finishes or times out
+                slot.wait_done(std::chrono::steady_clock::time_point::max(), 0u);
+            }
+            slot.reset();
             return status_e::SUCCESS;
         }
     };
 
+    /// @brief the thread safe factory, with its default timeouts set by template arguments (see interface::thread_safe)
+    template <typename open_opts_type,
+              uint64_t default_recv_timeout_ns,
+              uint64_t default_send_timeout_ns,
+              uint64_t default_open_timeout_ns,
+              uint64_t default_clse_timeout_ns>
+    using threadsafe_factory = factory<open_opts_type,
+                                       policy::threadsafe_defaults::with_timeouts<policy::timeouts<default_recv_timeout_ns,
+                                                                                                   default_send_timeout_ns,
+                                                                                                   default_open_timeout_ns,
+                                                                                                   default_clse_timeout_ns>>>;
+
+    /// @brief the single-producer/single-consumer thread safe factory, for interfaces where at most one thread at a time sends, and
+    /// at most one thread at a time receives, with its default timeouts set by template arguments (see interface::thread_safe_spsc)
+    template <typename open_opts_type,
+              uint64_t default_recv_timeout_ns,
+              uint64_t default_send_timeout_ns,
+              uint64_t default_open_timeout_ns,
+              uint64_t default_clse_timeout_ns>
+    using spsc_threadsafe_factory = factory<open_opts_type,
+                                            policy::policies<policy::single_caller,
+                                                             policy::timeouts<default_recv_timeout_ns,
+                                                                              default_send_timeout_ns,
+                                                                              default_open_timeout_ns,
+                                                                              default_clse_timeout_ns>>>;
+
+    /// @brief the thread safe factory, with its hooks resolved statically through "derived_type", and its default timeouts set by
+    /// template arguments (see interface::thread_safe_static)
+    template <typename derived_type,
+              typename open_opts_type,
+              uint64_t default_recv_timeout_ns,
+              uint64_t default_send_timeout_ns,
+              uint64_t default_open_timeout_ns,
+              uint64_t default_clse_timeout_ns>
+    using static_threadsafe_factory = factory<open_opts_type,
+                                              typename policy::threadsafe_defaults::with_timeouts<policy::timeouts<default_recv_timeout_ns,
+                                                                                                                   default_send_timeout_ns,
+                                                                                                                   default_open_timeout_ns,
+                                                                                                                   default_clse_timeout_ns>>::
+                                                  template with_dispatch<policy::static_dispatch<derived_type>>>;
+
+    /// @brief the non-thread safe factory, with its hooks resolved statically through "derived_type", and its default timeouts set
+    /// by template arguments (see interface::raw_static)
+    template <typename derived_type,
+              typename open_opts_type,
+              uint64_t default_recv_timeout_ns,
+              uint64_t default_send_timeout_ns,
+              uint64_t default_open_timeout_ns,
+              uint64_t default_clse_timeout_ns>
+    using static_raw_factory = factory<open_opts_type,
+                                       typename policy::raw_defaults::with_timeouts<policy::timeouts<default_recv_timeout_ns,
+                                                                                                     default_send_timeout_ns,
+                                                                                                     default_open_timeout_ns,
+                                                                                                     default_clse_timeout_ns>>::
+                                           template with_dispatch<policy::static_dispatch<derived_type>>>;
+
+    /// @brief the non-thread safe factory, with its default timeouts set by template arguments (see interface::raw)
+    template <typename open_opts_type,
+              uint64_t default_recv_timeout_ns,
+              uint64_t default_send_timeout_ns,
+              uint64_t default_open_timeout_ns,
+              uint64_t default_clse_timeout_ns>
+    using raw_factory = factory<open_opts_type,
+                                policy::raw_defaults::with_timeouts<policy::timeouts<default_recv_timeout_ns,
+                                                                                     default_send_timeout_ns,
+                                                                                     default_open_timeout_ns,
+                                                                                     default_clse_timeout_ns>>>;
 } // namespace interface
 
-#endif // CPPTXRX_FACTORY_H_
\ No newline at end of file
+#endif // CPPTXRX_FACTORY_H_
@@ -0,0 +1,216 @@
+/// @file cpptxrx_fd_waiter.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines "interface::fd_waiter", a reusable helper for file descriptor based backends, that owns a persistent epoll set
+/// and the eventfd used by wake_process, and waits on them until the deadline of the active operations
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_FD_WAITER_H_
+#define CPPTXRX_FD_WAITER_H_
+
+#include "cpptxrx_op_types.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__) && defined(__GLIBC_PREREQ)
+#if __GLIBC_PREREQ(2, 35)
+#define CPPTXRX_HAS_EPOLL_PWAIT2 1
+#endif
+#endif
+#ifndef CPPTXRX_HAS_EPOLL_PWAIT2
+#define CPPTXRX_HAS_EPOLL_PWAIT2 0
+#endif
+
+namespace interface
+{
+    /// @brief waits for any number of file descriptors to be ready, using an epoll set that persists across waits (so there's no
+    /// FD_SETSIZE limit, or per-wait registration cost), with an optional eventfd that wake() signals, to be called from a
+    /// threadsafe backend's wake_process. Waits are bounded by the active operations' timeouts and next_wakeup, to within a
+    /// nanosecond where epoll_pwait2 is available, and otherwise rounded up to the next millisecond.
+    class fd_waiter
+    {
+        int epoll_fd = -1;
+        int wake_fd  = -1;
+        bool use_pwait2{CPPTXRX_HAS_EPOLL_PWAIT2 != 0}; // cleared if the kernel turns out not to support it
+
+        // tracked atomically so that it can be reported from any thread by a backend's fds_used()
+        std::atomic<size_t> fds_open{0u};
+
+        void update_fds_open()
+        {
+            fds_open.store(static_cast<size_t>(epoll_fd >= 0) + static_cast<size_t>(wake_fd >= 0), std::memory_order_relaxed);
+        }
+
+        int epoll_wait_for(epoll_event *events, int max_events, std::chrono::nanoseconds timeout)
+        {
+            const bool forever = timeout == std::chrono::nanoseconds::max();
+#if CPPTXRX_HAS_EPOLL_PWAIT2
+            if (use_pwait2)
+            {
+                timespec ts{};
+                if (!forever)
+                {
+                    ts.tv_sec  = static_cast<time_t>(std::chrono::duration_cast<std::chrono::seconds>(timeout).count());
+                    ts.tv_nsec = static_cast<long>((timeout - std::chrono::seconds(ts.tv_sec)).count());
+                }
+                int ready = ::epoll_pwait2(epoll_fd, events, max_events, forever ? nullptr : &ts, nullptr);
+                if (ready >= 0 || errno != ENOSYS)
+                    return ready;
+                use_pwait2 = false;
+            }
+#endif
+            // round up, so that the wait never ends before the deadline (which would spin until it passes)
+            constexpr auto max_ms = std::chrono::milliseconds(INT32_MAX);
+            const auto timeout_ms = std::chrono::ceil<std::chrono::milliseconds>(std::min<std::chrono::nanoseconds>(timeout, max_ms));
+            return ::epoll_wait(epoll_fd, events, max_events, forever ? -1 : static_cast<int>(timeout_ms.count()));
+        }
+
+    public:
+        fd_waiter()                             = default;
+        fd_waiter(const fd_waiter &)            = delete;
+        fd_waiter &operator=(const fd_waiter &) = delete;
+        ~fd_waiter()
+        {
+            destruct();
+        }
+
+        /// @brief creates the epoll set, and the wake eventfd if the backend is threadsafe, meant to be called from construct()
+        ///
+        /// @param    wakeable: true to create the eventfd that wake() signals
+        /// @return   false: if a file descriptor couldn't be created (see errno)
+        bool construct(bool wakeable)
+        {
+            epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+            if (epoll_fd >= 0 && wakeable)
+            {
+                wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                if (wake_fd >= 0 && !add(wake_fd, EPOLLIN))
+                {
+                    ::close(wake_fd);
+                    wake_fd = -1;
+                }
+            }
+            update_fds_open();
+            return epoll_fd >= 0 && (!wakeable || wake_fd >= 0);
+        }
+
+        /// @brief closes the epoll set and the wake eventfd, meant to be called from destruct()
+        ///
+        /// @return   false: if closing either of them failed
+        bool destruct()
+        {
+            bool closed = true;
+            if (wake_fd != -1 && ::close(wake_fd) != 0)
+                closed = false;
+            if (epoll_fd != -1 && ::close(epoll_fd) != 0)
+                closed = false;
+            wake_fd  = -1;
+            epoll_fd = -1;
+            update_fds_open();
+            return closed;
+        }
+
+        /// @brief returns the number of file descriptors held by the waiter itself
+        [[nodiscard]] size_t fds_used() const
+        {
+            return fds_open.load(std::memory_order_relaxed);
+        }
+
+        /// @brief wakes a thread blocked in wait, or makes its next wait return right away, meant to be called from wake_process.
+        /// Can be called from any thread.
+        ///
+        /// @return   false: if the eventfd couldn't be signaled
+        bool wake() noexcept
+        {
+            uint64_t val = 1;
+            return ::write(wake_fd, &val, sizeof(val)) == sizeof(val);
+        }
+
+        /// @brief starts watching a file descriptor
+        ///
+        /// @param    fd: the file descriptor to watch
+        /// @param    events: the epoll events to wait for (like EPOLLIN/EPOLLOUT), where errors and hang ups are always reported
+        /// @return   false: if it couldn't be added (see errno)
+        bool add(int fd, uint32_t events)
+        {
+            epoll_event event{};
+            event.events  = events;
+            event.data.fd = fd;
+            return ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+        }
+
+        /// @brief changes the events waited for on a watched file descriptor
+        ///
+        /// @param    fd: the watched file descriptor
+        /// @param    events: the new epoll events to wait for
+        /// @return   false: if it couldn't be modified (see errno)
+        bool modify(int fd, uint32_t events)
+        {
+            epoll_event event{};
+            event.events  = events;
+            event.data.fd = fd;
+            return ::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event) == 0;
+        }
+
+        /// @brief stops watching a file descriptor, which should be done before it's closed
+        ///
+        /// @param    fd: the watched file descriptor
+        /// @return   false: if it couldn't be removed (see errno)
+        bool remove(int fd)
+        {
+            return ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr) == 0;
+        }
+
+        /// @brief waits until a watched file descriptor is ready, wake() is called, or the timeout passes
+        ///
+        /// @param    events: where the ready file descriptors are output (in data.fd), excluding the wake eventfd
+        /// @param    max_events: the size of "events"
+        /// @param    timeout: the longest time to wait, where 0 only polls, and std::chrono::nanoseconds::max() waits forever
+        /// @return   int: the number of ready file descriptors output, 0 if it timed out or was woken, or -1 on an error (see errno)
+        int wait(epoll_event *events, int max_events, std::chrono::nanoseconds timeout)
+        {
+            int ready = epoll_wait_for(events, max_events, timeout);
+            if (ready < 0)
+                return errno == EINTR ? 0 : -1;
+
+            // consume any wake signal, and leave only the backend's file descriptors in the output
+            int num_out = 0;
+            for (int i = 0; i < ready; i++)
+            {
+                if (wake_fd >= 0 && events[i].data.fd == wake_fd)
+                {
+                    uint64_t val;
+                    if (::read(wake_fd, &val, sizeof(val)) == -1 && errno != EAGAIN)
+                        return -1;
+                    continue;
+                }
+                events[num_out++] = events[i];
+            }
+            return num_out;
+        }
+
+        /// @brief waits like above, until the earliest of the active send/receive timeouts and next_wakeup, or without waiting at
+        /// all while driven by an external event loop (see poll_once)
+        ///
+        /// @param    transactions: the backend's active operations
+        /// @param    events: the array the ready file descriptors are output to
+        /// @return   int: the number of ready file descriptors output, 0 if it timed out or was woken, or -1 on an error (see errno)
+        template <size_t max_events>
+        int wait(const op_instructions &transactions, epoll_event (&events)[max_events])
+        {
+            static_assert(max_events > 0u && max_events <= INT32_MAX, "needs room for at least one event");
+            return wait(events, static_cast<int>(max_events),
+                        transactions.poll_only ? std::chrono::nanoseconds(0) : transactions.duration_until_wakeup());
+        }
+    };
+} // namespace interface
+
+#endif // CPPTXRX_FD_WAITER_H_
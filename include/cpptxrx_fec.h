@@ -0,0 +1,471 @@
+/// @file cpptxrx_fec.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines "interface::xor_fec", a forward error correction decorator that sends one XOR parity datagram per group of
+/// data datagrams, so that the receiver can rebuild one lost datagram per group without a retransmit, and "interface::xor_into",
+/// the vectorized XOR it uses
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_FEC_H_
+#define CPPTXRX_FEC_H_
+
+#include "cpptxrx_decorator.h"
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CPPTXRX_HAS_X86_XOR 1
+#else
+#define CPPTXRX_HAS_X86_XOR 0
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CPPTXRX_HAS_NEON_XOR 1
+#else
+#define CPPTXRX_HAS_NEON_XOR 0
+#endif
+
+namespace interface
+{
+    /// @brief the portable XOR, a word at a time
+    inline void xor_into_scalar(uint8_t *dst, const uint8_t *src, size_t size) noexcept
+    {
+        for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), dst += sizeof(uint64_t), src += sizeof(uint64_t))
+        {
+            uint64_t a, b;
+            memcpy(&a, dst, sizeof(a));
+            memcpy(&b, src, sizeof(b));
+            a ^= b;
+            memcpy(dst, &a, sizeof(a));
+        }
+        for (; size > 0u; size--)
+            *dst++ ^= *src++;
+    }
+
+#if CPPTXRX_HAS_X86_XOR
+    /// @brief the XOR using 16 byte SSE2 vectors
+    __attribute__((target("sse2"))) inline void xor_into_sse2(uint8_t *dst, const uint8_t *src, size_t size) noexcept
+    {
+        for (; size >= 16u; size -= 16u, dst += 16u, src += 16u)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_xor_si128(a, b));
+        }
+        xor_into_scalar(dst, src, size);
+    }
+
+    /// @brief the XOR using 32 byte AVX2 vectors, two at a time
+    __attribute__((target("avx2"))) inline void xor_into_avx2(uint8_t *dst, const uint8_t *src, size_t size) noexcept
+    {
+        for (; size >= 64u; size -= 64u, dst += 64u, src += 64u)
+        {
+            const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst));
+            const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + 32u));
+            const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+            const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 32u));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_xor_si256(a0, b0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 32u), _mm256_xor_si256(a1, b1));
+        }
+        for (; size >= 32u; size -= 32u, dst += 32u, src += 32u)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_xor_si256(a, b));
+        }
+        xor_into_sse2(dst, src, size);
+    }
+#endif
+
+#if CPPTXRX_HAS_NEON_XOR
+    /// @brief the XOR using 16 byte NEON vectors, which every aarch64 CPU has
+    inline void xor_into_neon(uint8_t *dst, const uint8_t *src, size_t size) noexcept
+    {
+        for (; size >= 16u; size -= 16u, dst += 16u, src += 16u)
+            vst1q_u8(dst, veorq_u8(vld1q_u8(dst), vld1q_u8(src)));
+        xor_into_scalar(dst, src, size);
+    }
+#endif
+
+    /// @brief an XOR implementation, and its name
+    struct xor_implementation
+    {
+        void (*compute)(uint8_t *, const uint8_t *, size_t) noexcept;
+        const char *name;
+    };
+
+    /// @brief returns the fastest XOR implementation the CPU supports, which is picked once, the first time it's called
+    [[nodiscard]] inline const xor_implementation &xor_best_implementation() noexcept
+    {
+        static const xor_implementation best = []() -> xor_implementation
+        {
+#if CPPTXRX_HAS_X86_XOR
+            if (__builtin_cpu_supports("avx2"))
+                return {&xor_into_avx2, "avx2"};
+            if (__builtin_cpu_supports("sse2"))
+                return {&xor_into_sse2, "sse2"};
+#endif
+#if CPPTXRX_HAS_NEON_XOR
+            return {&xor_into_neon, "neon"};
+#else
+            return {&xor_into_scalar, "scalar"};
+#endif
+        }();
+        return best;
+    }
+
+    /// @brief XORs "size" bytes of "src" into "dst", using the fastest implementation the CPU supports
+    inline void xor_into(uint8_t *dst, const uint8_t *src, size_t size) noexcept
+    {
+        xor_best_implementation().compute(dst, src, size);
+    }
+
+    /// @brief the counts of the groups seen by an xor_fec decorator
+    struct fec_stats
+    {
+        uint64_t recovered     = 0u; // lost data datagrams rebuilt from their group's parity
+        uint64_t unrecoverable = 0u; // groups that were still missing data when they were replaced by newer groups
+        uint64_t duplicates    = 0u; // data datagrams dropped since they were already received, or rebuilt
+        uint64_t malformed     = 0u; // datagrams dropped since they were too short, or their trailer was invalid
+        uint64_t late          = 0u; // datagrams from a group that had already been replaced by a newer one, so they weren't used
+    };
+
+    /// @brief a forward error correction decorator that sends one parity datagram after every "group_size" data datagrams,
+    /// holding the XOR of their payloads and lengths, so that the receiver can rebuild any one lost datagram of a group right
+    /// away, instead of waiting a round trip for a retransmit. Consecutive messages are dealt round robin into "interleave"
+    /// groups at a time, so that a burst of up to "interleave" consecutive losses is still one loss per group. Each datagram
+    /// gets an 8 byte trailer, and receive buffers need room for it, and for the largest message of the group (since that's
+    /// the size of the parity). Messages are delivered as they arrive, with a rebuilt message delivered by the next receive
+    /// call, so stack a sequencing decorator and jitter buffer on top for ordered delivery. The final, partial, groups of a
+    /// stream aren't protected, since their parity is only sent once they're full. A datagram arriving after a newer group has
+    /// taken its group's slot is counted as late, and delivered if it holds data, rather than evicting the newer group, unless
+    /// it's so far behind that the sender must have restarted. Any number of threads may send at a time
+    /// (one at a time, since the parity is shared), but only one thread may receive at a time.
+    ///
+    /// @tparam   group_size: the number of data datagrams per parity datagram, "K", from 2 to 32, where the overhead is 1/K
+    /// @tparam   interleave: the number of groups filled at a time
+    /// @tparam   max_message_size: the largest message that can be sent, which sets the size of the preallocated parity buffers
+    template <size_t group_size = 4u, size_t interleave = 1u, size_t max_message_size = 1464u>
+    class xor_fec : public decorator
+    {
+    public:
+        /// @brief the number of bytes added to the end of every datagram
+        static constexpr size_t trailer_size = 8u;
+
+    private:
+        static_assert(group_size >= 2u && group_size <= 32u, "group_size must be from 2 to 32");
+        static_assert(interleave >= 1u && interleave <= 256u, "interleave must be from 1 to 256");
+        static_assert(max_message_size <= UINT16_MAX, "the length of a message must fit in 16 bits");
+
+        // the trailer: [uint16 XOR of the group's lengths (parity only)][uint32 group id][uint8 position in the group, or the group
+        // size for parity][uint8 kind]
+        enum kind_e : uint8_t
+        {
+            DATA_KIND   = 0xD0,
+            PARITY_KIND = 0xFE
+        };
+
+        struct trailer
+        {
+            uint16_t length_xor = 0u;
+            uint32_t group      = 0u;
+            uint8_t position    = 0u;
+            uint8_t kind        = 0u;
+        };
+
+        static void store_trailer(uint8_t *p, const trailer &t) noexcept
+        {
+            p[0] = static_cast<uint8_t>(t.length_xor);
+            p[1] = static_cast<uint8_t>(t.length_xor >> 8u);
+            for (size_t i = 0; i < 4u; i++)
+                p[2u + i] = static_cast<uint8_t>(t.group >> (8u * i));
+            p[6] = t.position;
+            p[7] = t.kind;
+        }
+        static trailer load_trailer(const uint8_t *p) noexcept
+        {
+            trailer t{};
+            t.length_xor = static_cast<uint16_t>(p[0] | (p[1] << 8u));
+            for (size_t i = 0; i < 4u; i++)
+                t.group |= static_cast<uint32_t>(p[2u + i]) << (8u * i);
+            t.position = p[6];
+            t.kind     = p[7];
+            return t;
+        }
+
+        // ---------------------------------------- sending side ----------------------------------------
+
+        /// @brief the parity being built for one of the interleaved groups, with room for its trailer
+        struct sending_group
+        {
+            uint8_t parity[max_message_size + trailer_size] = {};
+            size_t extent                                   = 0u; // the size of the largest message XORed in so far
+            uint16_t length_xor                             = 0u;
+            uint32_t id                                     = 0u;
+            size_t count                                    = 0u;
+        };
+
+        std::mutex send_mutex{};
+        sending_group sending[interleave] = {};
+        size_t next_lane                  = 0u;
+        uint32_t next_group               = 0u;
+        sending_group *p_unsent_parity    = nullptr; // a full group whose parity couldn't be sent by try_send yet
+
+        status_e send_parity(sending_group &group, std::chrono::steady_clock::time_point end_time, bool blocking, priority_e priority)
+        {
+            store_trailer(group.parity + group.extent, {group.length_xor, group.id, static_cast<uint8_t>(group_size), PARITY_KIND});
+            status_e status = send_inner(group.parity, group.extent + trailer_size, end_time, blocking, priority);
+            p_unsent_parity = status == status_e::WOULD_BLOCK ? &group : nullptr;
+            return status;
+        }
+
+        // a parity datagram is sent at the priority of the send that completed its group, or that's flushing it
+        status_e send_protected(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking,
+                                priority_e priority)
+        {
+            if (size > max_message_size)
+                return too_large();
+            if (p_unsent_parity != nullptr)
+                if (status_e status = send_parity(*p_unsent_parity, end_time, blocking, priority); status == status_e::WOULD_BLOCK)
+                    return status;
+
+            sending_group &group  = sending[next_lane];
+            const trailer t       = {0u, group.count == 0u ? next_group : group.id, static_cast<uint8_t>(group.count), DATA_KIND};
+            auto append_trailer   = [&t](uint8_t *framed, size_t message_size)
+            { store_trailer(framed + message_size, t); };
+            const status_e status = send_with_trailer<max_message_size, trailer_size>(data, size, end_time, blocking, priority, append_trailer);
+            if (status == status_e::WOULD_BLOCK)
+                return status;
+
+            // the message is part of the group even if sending it failed, since the receiver can rebuild it
+            if (group.count == 0u)
+            {
+                memset(group.parity, 0, group.extent + trailer_size); // including the last parity's trailer, past its extent
+                group.extent     = 0u;
+                group.length_xor = 0u;
+                group.id         = next_group++;
+            }
+            xor_into(group.parity, data, size);
+            group.extent = size > group.extent ? size : group.extent;
+            group.length_xor ^= static_cast<uint16_t>(size);
+            next_lane = (next_lane + 1u) % interleave;
+            if (++group.count == group_size)
+            {
+                group.count = 0u;
+                send_parity(group, end_time, blocking, priority);
+            }
+            return status;
+        }
+
+        // ---------------------------------------- receiving side ----------------------------------------
+
+        /// @brief the XOR of everything received so far for one group, which is the lost datagram once all but one of the
+        /// group's datagrams (including its parity) have been received
+        struct receiving_group
+        {
+            uint8_t accumulated[max_message_size] = {};
+            size_t extent                         = 0u;
+            uint16_t length_xor                   = 0u;
+            uint32_t id                           = 0u;
+            uint32_t received_mask                = 0u; // a bit per data position received (or rebuilt)
+            bool has_parity                       = false;
+            bool active                           = false;
+        };
+
+        // the current and previous groups of each lane, indexed by group id % (2 * interleave)
+        static constexpr size_t num_receiving = 2u * interleave;
+        static constexpr uint32_t full_mask   = static_cast<uint32_t>((uint64_t{1u} << group_size) - 1u);
+
+        // a datagram from further behind its slot's group than this is taken as the sender restarting its group ids, rather than
+        // as arriving late, so that the receiver starts over from it instead of ignoring the sender from then on
+        static constexpr uint32_t max_late_groups = 4u * num_receiving;
+        receiving_group receiving[num_receiving] = {};
+
+        uint8_t rebuilt[max_message_size] = {}; // a rebuilt message, that's delivered by the next receive call
+        size_t rebuilt_size               = 0u;
+        bool has_rebuilt                  = false;
+
+        std::atomic<uint64_t> recovered{0u};
+        std::atomic<uint64_t> unrecoverable{0u};
+        std::atomic<uint64_t> duplicates{0u};
+        std::atomic<uint64_t> malformed{0u};
+        std::atomic<uint64_t> late{0u};
+
+        /// @brief returns the group a datagram belongs to, replacing an older group in its slot if it's the first of a newer one
+        ///
+        /// @return   receiving_group*: the group, or nullptr if the datagram is from a group older than the one in its slot
+        receiving_group *group_for(uint32_t id) noexcept
+        {
+            receiving_group &group = receiving[id % num_receiving];
+
+            // compared with wrapping arithmetic, so that the group ids can run forever
+            const int32_t ahead = static_cast<int32_t>(id - group.id);
+            if (group.active && ahead < 0 && static_cast<uint32_t>(-static_cast<int64_t>(ahead)) <= max_late_groups)
+                return nullptr;
+            if (!group.active || group.id != id)
+            {
+                if (group.active && group.received_mask != full_mask)
+                    increment(unrecoverable);
+                memset(group.accumulated, 0, group.extent);
+                group.extent        = 0u;
+                group.length_xor    = 0u;
+                group.id            = id;
+                group.received_mask = 0u;
+                group.has_parity    = false;
+                group.active        = true;
+            }
+            return &group;
+        }
+
+        void accumulate(receiving_group &group, const uint8_t *payload, size_t size, uint16_t length_xor) noexcept
+        {
+            xor_into(group.accumulated, payload, size);
+            group.extent = size > group.extent ? size : group.extent;
+            group.length_xor ^= length_xor;
+        }
+
+        /// @brief rebuilds the group's one missing datagram, once everything else in the group has been received
+        void try_rebuild(receiving_group &group) noexcept
+        {
+            const uint32_t missing = full_mask & ~group.received_mask;
+            if (!group.has_parity || missing == 0u || (missing & (missing - 1u)) != 0u)
+                return;
+            group.received_mask = full_mask;
+            if (group.length_xor > group.extent)
+            {
+                increment(malformed);
+                return;
+            }
+            rebuilt_size = group.length_xor;
+            memcpy(rebuilt, group.accumulated, rebuilt_size);
+            has_rebuilt = true;
+            increment(recovered);
+        }
+
+        /// @brief tracks a received datagram, leaving only the message in "data" if it's a data datagram
+        ///
+        /// @return   true: if the datagram shouldn't be delivered, since it's a parity datagram, a duplicate, or malformed
+        bool consume(const uint8_t *data, recv_ret &result) noexcept
+        {
+            if (!received_whole(result))
+                return false;
+            if (result.size < trailer_size)
+            {
+                increment(malformed);
+                return true;
+            }
+            const size_t payload_size = result.size - trailer_size;
+            const trailer t           = load_trailer(data + payload_size);
+            // parity datagrams carry the group size instead of a position, which catches the two ends being configured differently
+            const bool valid_kind = (t.kind == DATA_KIND && t.position < group_size) || (t.kind == PARITY_KIND && t.position == group_size);
+            if (payload_size > max_message_size || !valid_kind)
+            {
+                increment(malformed);
+                return true;
+            }
+
+            receiving_group *p_group = group_for(t.group);
+            if (p_group == nullptr)
+            {
+                // too late to help rebuild anything, but a data datagram is still delivered, since it wasn't rebuilt either
+                increment(late);
+                result.size = payload_size;
+                return t.kind == PARITY_KIND;
+            }
+            receiving_group &group = *p_group;
+            if (t.kind == PARITY_KIND)
+            {
+                if (!group.has_parity)
+                {
+                    group.has_parity = true;
+                    accumulate(group, data, payload_size, t.length_xor);
+                    try_rebuild(group);
+                }
+                return true;
+            }
+            const uint32_t bit = uint32_t{1u} << t.position;
+            if ((group.received_mask & bit) != 0u)
+            {
+                increment(duplicates);
+                return true;
+            }
+            group.received_mask |= bit;
+            accumulate(group, data, payload_size, static_cast<uint16_t>(payload_size));
+            try_rebuild(group);
+            result.size = payload_size;
+            return false;
+        }
+
+        recv_ret deliver_rebuilt(uint8_t *const data, size_t size) noexcept
+        {
+            const size_t copied = rebuilt_size < size ? rebuilt_size : size;
+            memcpy(data, rebuilt, copied);
+            has_rebuilt = false;
+            recv_ret result{status_e::SUCCESS, copied};
+            result.truncated = rebuilt_size > size;
+            return result;
+        }
+
+        recv_ret receive_protected(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking)
+        {
+            if (has_rebuilt)
+                return deliver_rebuilt(data, size);
+            auto drop_unless_delivered = [this, size](uint8_t *message, recv_ret &result)
+            {
+                if (!consume(message, result))
+                    return false;
+                // a dropped datagram (like a parity) can complete a group, whose rebuilt message is delivered instead
+                if (!has_rebuilt)
+                    return true;
+                result = deliver_rebuilt(message, size);
+                return false;
+            };
+            return receive_until_kept(data, size, end_time, blocking, drop_unless_delivered);
+        }
+
+    public:
+        using decorator::decorator;
+        using decorator::receive;
+        using decorator::send;
+
+        /// @brief returns the counts of the groups seen so far
+        [[nodiscard]] fec_stats stats() const noexcept
+        {
+            fec_stats report{};
+            report.recovered     = recovered.load(std::memory_order_relaxed);
+            report.unrecoverable = unrecoverable.load(std::memory_order_relaxed);
+            report.duplicates    = duplicates.load(std::memory_order_relaxed);
+            report.malformed     = malformed.load(std::memory_order_relaxed);
+            report.late          = late.load(std::memory_order_relaxed);
+            return report;
+        }
+
+        status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, priority_e priority) override
+        {
+            std::lock_guard<std::mutex> lock(send_mutex);
+            return send_protected(data, size, end_time, true, priority);
+        }
+        recv_ret receive(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time) override
+        {
+            return receive_protected(data, size, end_time, true);
+        }
+        status_e try_send(const uint8_t *const data, size_t size) override
+        {
+            std::unique_lock<std::mutex> lock(send_mutex, std::try_to_lock);
+            if (!lock.owns_lock())
+                return status_e::WOULD_BLOCK;
+            return send_protected(data, size, std::chrono::steady_clock::time_point::max(), false, priority_e::NORMAL);
+        }
+        recv_ret try_receive(uint8_t *const data, size_t size) override
+        {
+            return receive_protected(data, size, std::chrono::steady_clock::time_point::max(), false);
+        }
+    };
+} // namespace interface
+
+#endif // CPPTXRX_FEC_H_
@@ -0,0 +1,272 @@
+/// @file cpptxrx_handoff.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines the lock-free primitives used by "interface::policy::single_caller" interfaces to hand operations to
+/// their management thread: a single item "handoff_slot", and a "doorbell" the management thread sleeps on while idle
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_HANDOFF_H_
+#define CPPTXRX_HANDOFF_H_
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+#if defined(__linux__) && __has_include(<linux/futex.h>)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#define CPPTXRX_HAS_FUTEX 1
+#else
+#define CPPTXRX_HAS_FUTEX 0
+#endif
+
+namespace interface
+{
+    /// @brief blocks while "word" still holds "expected", until woken by futex_wake_all, or until the timeout passes.
+    /// Can return early (spuriously), so callers must re-check their condition. Where futexes aren't available, it
+    /// sleeps for a short interval instead.
+    ///
+    /// @param    word: the word to wait on
+    /// @param    expected: the value the word held when the caller decided to wait
+    /// @param    timeout: the longest time to wait for
+    inline void futex_wait(std::atomic<uint32_t> &word, uint32_t expected, std::chrono::nanoseconds timeout)
+    {
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futexes require a plain 32 bit word");
+        if (timeout <= std::chrono::nanoseconds::zero())
+            return;
+#if CPPTXRX_HAS_FUTEX
+        const bool forever = timeout >= std::chrono::hours(24 * 365);
+        timespec ts{};
+        if (!forever)
+        {
+            ts.tv_sec  = static_cast<time_t>(std::chrono::duration_cast<std::chrono::seconds>(timeout).count());
+            ts.tv_nsec = static_cast<long>((timeout - std::chrono::seconds(ts.tv_sec)).count());
+        }
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, forever ? nullptr : &ts, nullptr, 0);
+#else
+        if (word.load(std::memory_order_acquire) == expected)
+            std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout, std::chrono::microseconds(50)));
+#endif
+    }
+
+    /// @brief wakes every thread blocked in futex_wait on "word"
+    ///
+    /// @param    word: the word to wake the waiters of
+    inline void futex_wake_all(std::atomic<uint32_t> &word)
+    {
+#if CPPTXRX_HAS_FUTEX
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#else
+        (void)word;
+#endif
+    }
+
+    /// @brief a single item slot, that one caller thread posts an item into, and one processing thread accepts and then
+    /// completes it, using release/acquire atomics. The caller only makes a system call if it has to sleep, and the processor
+    /// only makes one to wake a caller that's actually asleep.
+    ///
+    /// @tparam   T: the type of item pointed to
+    template <typename T>
+    class handoff_slot
+    {
+        static constexpr uint32_t EMPTY      = 0u;
+        static constexpr uint32_t REQUESTED  = 1u;
+        static constexpr uint32_t ACCEPTED   = 2u;
+        static constexpr uint32_t DONE       = 3u;
+        static constexpr uint32_t PHASE_MASK = 3u;
+        static constexpr uint32_t WAITING    = 4u; // set by a caller that's asleep in futex_wait
+
+        std::atomic<uint32_t> state{EMPTY};
+        T *p_item{nullptr};
+#ifndef NDEBUG
+        std::atomic<uint32_t> callers{0u};
+#endif
+
+    public:
+        handoff_slot()                                = default;
+        handoff_slot(const handoff_slot &)            = delete;
+        handoff_slot &operator=(const handoff_slot &) = delete;
+
+        /// @brief marks the start of a caller's use of the slot, which debug builds use to check that there is only ever one
+        /// caller at a time
+        inline void begin_call() noexcept
+        {
+#ifndef NDEBUG
+            const uint32_t other_callers = callers.fetch_add(1u, std::memory_order_relaxed);
+            assert(other_callers == 0u && "a single_caller interface was used by more than one thread at a time for the same operation");
+            (void)other_callers;
+#endif
+        }
+
+        /// @brief marks the end of a caller's use of the slot
+        inline void end_call() noexcept
+        {
+#ifndef NDEBUG
+            callers.fetch_sub(1u, std::memory_order_relaxed);
+#endif
+        }
+
+        // ---------------------------------------- caller side ----------------------------------------
+
+        /// @brief posts an item for the processor to accept, the slot must be empty
+        ///
+        /// @param    item: the item to post, which must stay alive until the slot is done, or withdrawn
+        inline void post(T *item) noexcept
+        {
+            p_item = item;
+            state.store(REQUESTED, std::memory_order_seq_cst);
+        }
+
+        /// @brief takes back a posted item, if the processor hasn't accepted it yet
+        ///
+        /// @return   true: if the item was withdrawn, leaving the slot empty
+        /// @return   false: if the processor already accepted the item, so the caller must wait until it's done
+        inline bool withdraw() noexcept
+        {
+            uint32_t current = state.load(std::memory_order_acquire);
+            while ((current & PHASE_MASK) == REQUESTED)
+                if (state.compare_exchange_weak(current, EMPTY, std::memory_order_acq_rel, std::memory_order_acquire))
+                    return true;
+            return false;
+        }
+
+        /// @brief waits for the processor to finish with the posted item, by first yielding "spins" times, and then sleeping
+        ///
+        /// @param    end_time: when to stop waiting
+        /// @param    spins: how many times to yield and re-check before sleeping
+        /// @return   true: if the item is done
+        /// @return   false: if end_time passed first
+        inline bool wait_done(std::chrono::steady_clock::time_point end_time, size_t spins) noexcept
+        {
+            for (size_t i = 0;; i++)
+            {
+                uint32_t current = state.load(std::memory_order_acquire);
+                if ((current & PHASE_MASK) == DONE)
+                    return true;
+                if (i < spins)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if ((current & WAITING) == 0u)
+                {
+                    // let the processor know it needs to wake this thread, before actually going to sleep
+                    if (!state.compare_exchange_weak(current, current | WAITING, std::memory_order_acq_rel, std::memory_order_acquire))
+                        continue;
+                    current |= WAITING;
+                }
+                const auto now = std::chrono::steady_clock::now();
+                if (now >= end_time)
+                    return false;
+                futex_wait(state, current, end_time - now);
+            }
+        }
+
+        /// @brief empties a done slot, so that the caller can post another item
+        inline void reset() noexcept
+        {
+            state.store(EMPTY, std::memory_order_relaxed);
+        }
+
+        // ---------------------------------------- processor side ----------------------------------------
+
+        /// @brief returns true if an item is waiting to be accepted
+        [[nodiscard]] inline bool is_requested() const noexcept
+        {
+            return (state.load(std::memory_order_seq_cst) & PHASE_MASK) == REQUESTED;
+        }
+
+        /// @brief returns true if an item is waiting to be accepted, or was accepted but isn't done yet
+        [[nodiscard]] inline bool is_pending() const noexcept
+        {
+            const uint32_t phase = state.load(std::memory_order_seq_cst) & PHASE_MASK;
+            return phase == REQUESTED || phase == ACCEPTED;
+        }
+
+        /// @brief accepts the posted item, if there is one that hasn't been withdrawn
+        ///
+        /// @return   T*: the accepted item, or nullptr if there wasn't one
+        [[nodiscard]] inline T *accept() noexcept
+        {
+            // seq_cst, so that an item posted by a caller that saw the processor waiting on a doorbell is always seen
+            uint32_t current = state.load(std::memory_order_seq_cst);
+            while ((current & PHASE_MASK) == REQUESTED)
+                if (state.compare_exchange_weak(current, (current & WAITING) | ACCEPTED, std::memory_order_acq_rel, std::memory_order_acquire))
+                    return p_item;
+            return nullptr;
+        }
+
+        /// @brief hands an accepted item back to the caller, waking it up if it's asleep
+        inline void complete() noexcept
+        {
+            if ((state.exchange(DONE, std::memory_order_acq_rel) & WAITING) != 0u)
+                futex_wake_all(state);
+        }
+    };
+
+    /// @brief lets a thread sleep while idle, until another thread rings the doorbell, without the ringing thread needing to take
+    /// a lock, or make a system call when the sleeping thread is already awake
+    class doorbell
+    {
+        std::atomic<uint32_t> sequence{0u};
+        std::atomic<uint32_t> sleepers{0u};
+
+    public:
+        doorbell()                            = default;
+        doorbell(const doorbell &)            = delete;
+        doorbell &operator=(const doorbell &) = delete;
+
+        /// @brief rings the doorbell, the ringing thread must make its condition true (with a seq_cst store, or while holding
+        /// the waiter's lock) before calling this
+        ///
+        /// @return   true: if a thread was inside wait_for, so it's guaranteed to see the condition before it does anything else
+        /// @return   false: if no thread was waiting, so the ring was skipped
+        inline bool ring() noexcept
+        {
+            if (sleepers.load(std::memory_order_seq_cst) == 0u)
+                return false;
+            sequence.fetch_add(1u, std::memory_order_seq_cst);
+            futex_wake_all(sequence);
+            return true;
+        }
+
+        /// @brief sleeps until "pred" is true, releasing "lk" while asleep, with "pred" only ever checked while "lk" is held
+        ///
+        /// @param    lk: the held lock protecting any non-atomic state "pred" reads
+        /// @param    timeout: the longest time to wait for
+        /// @param    pred: the condition to wait for, which must read any atomics it uses with std::memory_order_seq_cst
+        /// @return   the final value of pred(), where anything that's read with seq_cst after this returns is guaranteed to include
+        ///           the condition of any ring() that returned true
+        template <typename pred_type>
+        bool wait_for(std::unique_lock<std::mutex> &lk, std::chrono::nanoseconds timeout, pred_type pred)
+        {
+            const auto now      = std::chrono::steady_clock::now();
+            const auto end_time = timeout >= std::chrono::steady_clock::time_point::max() - now
+                                      ? std::chrono::steady_clock::time_point::max()
+                                      : now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+            while (true)
+            {
+                sleepers.fetch_add(1u, std::memory_order_seq_cst);
+                const uint32_t seen = sequence.load(std::memory_order_seq_cst);
+                const bool ready    = pred();
+                const auto remaining = end_time - std::chrono::steady_clock::now();
+                if (ready || remaining <= std::chrono::steady_clock::duration::zero())
+                {
+                    sleepers.fetch_sub(1u, std::memory_order_seq_cst);
+                    return ready;
+                }
+                lk.unlock();
+                futex_wait(sequence, seen, remaining);
+                lk.lock();
+                sleepers.fetch_sub(1u, std::memory_order_seq_cst);
+            }
+        }
+    };
+} // namespace interface
+
+#endif // CPPTXRX_HANDOFF_H_
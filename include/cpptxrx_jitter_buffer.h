@@ -0,0 +1,234 @@
+/// @file cpptxrx_jitter_buffer.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines "interface::jitter_buffer", a decorator that delivers the messages numbered by "interface::sequencing" in
+/// order, by holding the ones that arrive early until the gap before them fills, or until a hold time passes
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_JITTER_BUFFER_H_
+#define CPPTXRX_JITTER_BUFFER_H_
+
+#include "cpptxrx_sequencing.h"
+#include <atomic>
+#include <chrono>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace interface
+{
+    /// @brief the counts of the messages delivered by a jitter_buffer
+    struct jitter_stats
+    {
+        uint64_t in_order = 0u; // messages delivered as soon as they arrived
+        uint64_t released = 0u; // messages that arrived early, and were held until the messages before them were delivered
+        uint64_t skipped  = 0u; // sequence numbers given up on, since they didn't arrive within the hold time
+        uint64_t late     = 0u; // messages dropped since they arrived after being skipped, or were duplicates
+        uint64_t resyncs  = 0u; // times the order restarted from a message too far behind to be late, like after a sender restart
+    };
+
+    /// @brief a decorator that delivers messages in sequence number order, where a message that arrives early is held in a
+    /// preallocated slot until the messages before it arrive, or until it's been held for "hold_time", at which point the
+    /// missing messages are skipped. Messages that arrive after being skipped, and duplicates, are dropped. A message too far
+    /// ahead to fit in the window releases everything before it right away, and so does a message more than a window behind,
+    /// which restarts the order from it, since only a sender restart moves the numbering that far backwards. The order starts
+    /// from the first message received. The sending side only needs a sequencing decorator. Only one thread may receive at a
+    /// time.
+    ///
+    /// @tparam   window_size: the number of messages that can be held, which is also how far ahead of the next expected
+    ///           message one can arrive before forcing the window forward, which must be a power of two
+    /// @tparam   max_message_size: the largest message that can be held, matching the wrapped sequencing decorator
+    template <size_t window_size = 32u, size_t max_message_size = 1472u>
+    class jitter_buffer : public decorator
+    {
+        static_assert(window_size > 0u && (window_size & (window_size - 1u)) == 0u && window_size <= UINT32_MAX / 2u,
+                      "window_size must be a power of two, so sequence numbers keep their slots when they wrap");
+
+        /// @brief the details of a held message, kept apart from its data so that scanning them stays within a few cache lines
+        struct held_info
+        {
+            std::chrono::steady_clock::time_point arrival{};
+            size_t size    = 0u;
+            bool truncated = false;
+            bool filled    = false;
+        };
+
+        sequencing<max_message_size> &sequenced;
+        const std::chrono::nanoseconds hold_time;
+
+        held_info infos[window_size]                   = {}; // indexed by sequence number % window_size
+        uint8_t storage[window_size][max_message_size] = {};
+        held_info overflow_info                        = {}; // a message too far ahead to hold, that's delivered next
+        uint8_t overflow_data[max_message_size]        = {};
+        uint32_t overflow_sequence                     = 0u;
+        uint32_t next_expected                         = 0u;
+        size_t num_held                                = 0u;
+        bool started                                   = false;
+
+        std::atomic<uint64_t> in_order{0u};
+        std::atomic<uint64_t> released{0u};
+        std::atomic<uint64_t> skipped{0u};
+        std::atomic<uint64_t> late{0u};
+        std::atomic<uint64_t> resyncs{0u};
+
+        static inline size_t slot_of(uint32_t sequence) noexcept { return sequence % window_size; }
+
+        /// @brief copies a held message into the caller's buffer
+        recv_ret deliver(held_info &info, const uint8_t *held_data, uint8_t *const data, size_t size) noexcept
+        {
+            const size_t copied = info.size < size ? info.size : size;
+            memcpy(data, held_data, copied);
+            recv_ret result{status_e::SUCCESS, copied};
+            result.truncated = info.truncated || info.size > size;
+            info.filled      = false;
+            increment(released);
+            return result;
+        }
+
+        /// @brief copies a received message into a slot
+        static void hold(held_info &info, uint8_t *held_data, const uint8_t *data, const recv_ret &result,
+                         std::chrono::steady_clock::time_point now) noexcept
+        {
+            const size_t copied = result.size < max_message_size ? result.size : max_message_size;
+            memcpy(held_data, data, copied);
+            info = {now, copied, result.truncated || result.size > max_message_size, true};
+        }
+
+        /// @brief returns when the longest held message has to be released by
+        std::chrono::steady_clock::time_point release_deadline() const noexcept
+        {
+            auto oldest = std::chrono::steady_clock::time_point::max();
+            for (const held_info &info : infos)
+                if (info.filled && info.arrival < oldest)
+                    oldest = info.arrival;
+            return oldest + hold_time;
+        }
+
+        /// @brief gives up on the missing messages before the next held one, and delivers it
+        recv_ret skip_to_next_held(uint8_t *const data, size_t size) noexcept
+        {
+            uint32_t distance = 0u;
+            while (!infos[slot_of(next_expected + distance)].filled)
+                distance++;
+            increment(skipped, distance);
+            next_expected += distance;
+            num_held--;
+            const size_t slot = slot_of(next_expected++);
+            return deliver(infos[slot], storage[slot], data, size);
+        }
+
+        recv_ret receive_in_order(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking)
+        {
+            while (true)
+            {
+                // a message too far ahead to hold, or too far behind to be late, releases everything held before it, in
+                // order, and then itself
+                if (overflow_info.filled)
+                {
+                    if (num_held > 0u)
+                        return skip_to_next_held(data, size);
+                    if (static_cast<int32_t>(overflow_sequence - next_expected) > 0)
+                        increment(skipped, overflow_sequence - next_expected);
+                    else
+                        increment(resyncs);
+                    next_expected = overflow_sequence + 1u;
+                    return deliver(overflow_info, overflow_data, data, size);
+                }
+
+                auto deadline = end_time;
+                if (num_held > 0u)
+                {
+                    if (const size_t slot = slot_of(next_expected); infos[slot].filled)
+                    {
+                        num_held--;
+                        next_expected++;
+                        return deliver(infos[slot], storage[slot], data, size);
+                    }
+                    const auto release_time = release_deadline();
+                    if (std::chrono::steady_clock::now() >= release_time)
+                        return skip_to_next_held(data, size);
+                    if (release_time < deadline)
+                        deadline = release_time;
+                }
+
+                recv_ret result = blocking ? sequenced.receive(data, size, deadline) : sequenced.try_receive(data, size);
+                if (result.status != status_e::SUCCESS)
+                {
+                    // waking up to release a held message isn't the caller's timeout
+                    if (result.status == status_e::TIMED_OUT && deadline < end_time)
+                        continue;
+                    return result;
+                }
+
+                const uint32_t sequence = sequenced.last_sequence();
+                if (!started)
+                {
+                    started       = true;
+                    next_expected = sequence;
+                }
+                const int32_t ahead = static_cast<int32_t>(sequence - next_expected);
+                if (ahead == 0)
+                {
+                    next_expected++;
+                    increment(in_order);
+                    return result;
+                }
+
+                const auto now             = std::chrono::steady_clock::now();
+                const bool ahead_in_window = ahead > 0 && static_cast<uint32_t>(ahead) < window_size;
+                const bool late_in_window  = ahead < 0 && static_cast<uint32_t>(-static_cast<int64_t>(ahead)) <= window_size;
+                if (late_in_window || (ahead_in_window && infos[slot_of(sequence)].filled))
+                    increment(late);
+                else if (ahead_in_window)
+                {
+                    hold(infos[slot_of(sequence)], storage[slot_of(sequence)], data, result, now);
+                    num_held++;
+                }
+                else
+                {
+                    hold(overflow_info, overflow_data, data, result, now);
+                    overflow_sequence = sequence;
+                }
+            }
+        }
+
+    public:
+        /// @brief wraps a sequencing decorator, whose sequence numbers set the delivery order
+        ///
+        /// @param    sequenced_interface: the sequencing decorator to receive from, which must outlive the jitter buffer
+        /// @param    max_hold_time: the longest time to hold a message while waiting for the messages before it
+        jitter_buffer(sequencing<max_message_size> &sequenced_interface, std::chrono::nanoseconds max_hold_time) noexcept
+            : decorator(static_cast<abstract &>(sequenced_interface)), sequenced(sequenced_interface), hold_time(max_hold_time)
+        {
+        }
+
+        using decorator::receive;
+        using decorator::send;
+
+        /// @brief returns the counts of the messages delivered so far
+        [[nodiscard]] jitter_stats stats() const noexcept
+        {
+            jitter_stats report{};
+            report.in_order = in_order.load(std::memory_order_relaxed);
+            report.released = released.load(std::memory_order_relaxed);
+            report.skipped  = skipped.load(std::memory_order_relaxed);
+            report.late     = late.load(std::memory_order_relaxed);
+            report.resyncs  = resyncs.load(std::memory_order_relaxed);
+            return report;
+        }
+
+        /// @brief returns the number of messages currently held
+        [[nodiscard]] size_t held() const noexcept { return num_held + (overflow_info.filled ? 1u : 0u); }
+
+        recv_ret receive(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time) override
+        {
+            return receive_in_order(data, size, end_time, true);
+        }
+        recv_ret try_receive(uint8_t *const data, size_t size) override
+        {
+            return receive_in_order(data, size, std::chrono::steady_clock::time_point::max(), false);
+        }
+    };
+} // namespace interface
+
+#endif // CPPTXRX_JITTER_BUFFER_H_
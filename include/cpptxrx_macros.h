@@ -8,6 +8,7 @@
 /// Note that you can manually define the following patterns instead, though it is not recommended, since
 /// future versions of this library might modify the internals of the macros, making it harder to upgrade:
 ///
+///      friend typename class_name::factory_type; // only needed with interface::policy::static_dispatch
 ///      class_name()
 ///      {
 ///          if constexpr (!threadsafe)
@@ -29,6 +30,7 @@
 
 /// @brief import the constructor pattern for a new cpptxrx interface
 #define IMPORT_CPPTXRX_CTOR(class_name)              \
+    friend typename class_name::factory_type;        \
     class_name()                                     \
     {                                                \
         if constexpr (!threadsafe)                   \
@@ -10,15 +10,22 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/// @brief the cache line size used to keep state written by different threads on separate cache lines.
+/// std::hardware_destructive_interference_size isn't used directly, since its value can change with compiler
+/// flags (gcc warns about it being used in headers for that reason), so define this to override it if needed.
+#ifndef CPPTXRX_CACHE_LINE_SIZE
+#define CPPTXRX_CACHE_LINE_SIZE 64
+#endif
+
 namespace interface
 {
+    /// @brief the alignment used to avoid false sharing between fields written by different threads
+    inline constexpr size_t cache_line_size = CPPTXRX_CACHE_LINE_SIZE;
+
     class backend
     {
-        template <typename, uint64_t, uint64_t, uint64_t, uint64_t>
-        friend class threadsafe_factory;
-
-        template <typename, uint64_t, uint64_t, uint64_t, uint64_t>
-        friend class raw_factory;
+        template <typename, typename>
+        friend class factory;
 
         /// @brief the supported underlying operation categories
         enum class op_category_e : int
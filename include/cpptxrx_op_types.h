@@ -8,7 +8,9 @@
 #define CPPTXRX_OP_TYPES_H_
 
 #include "cpptxrx_status.h"
+#include <algorithm>
 #include <chrono>
+#include <initializer_list>
 #include <utility>
 
 namespace interface
@@ -43,7 +45,8 @@ namespace interface
             return end_time - now_time;
         }
 
-        /// @brief returns the duration until the end_time timeout, from the current time
+        /// @brief returns the duration until the end_time timeout, from the current time of std::chrono::steady_clock (backends
+        /// should pass "transactions.now()" instead, so that it's measured against the same clock end_time was set from)
         template <typename Dur = std::chrono::nanoseconds>
         Dur duration_until_timeout() const
         {
@@ -51,11 +54,20 @@ namespace interface
         }
     };
 
+    /// @brief the priority class of a send, which picks its lane in the send queue (see policy::priority_send_order), and that
+    /// backends can map to a network priority (like SO_PRIORITY and DSCP)
+    enum class priority_e : uint8_t
+    {
+        NORMAL, // bulk traffic
+        HIGH    // latency critical control traffic
+    };
+
     /// @brief the input arguments needed to perform a send operation
     struct send_op : common_op
     {
         const uint8_t *const send_data = nullptr;
         const size_t send_size         = 0u;
+        const priority_e priority      = priority_e::NORMAL;
     };
 
     /// @brief the input and output arguments needed to perform a receive operation
@@ -64,6 +76,44 @@ namespace interface
         uint8_t *const received_data  = nullptr;
         const size_t max_receive_size = 0u;
         size_t returned_recv_size     = 0u;
+
+        /// @brief true if the message was larger than the buffer, so that only the start of it was received
+        bool truncated = false;
+
+        /// @brief [[optional]] grows the caller's container to a new size, returning its data, or nullptr if it couldn't grow,
+        /// set by receive_into. It's called by the backend (usually on the management thread), so it must not throw.
+        uint8_t *(*const resize_container)(void *p_container, size_t size) noexcept = nullptr;
+        void *const p_container                                                      = nullptr;
+
+        /// @brief returns the buffer to receive a message of "message_size" bytes into, which is received_data, unless the
+        /// caller's container can grow (see receive_into), in which case it's grown to fit the message first. If growing it
+        /// fails, its current buffer is returned, so that the message is truncated.
+        ///
+        /// @param    message_size: the size of the message about to be received
+        /// @param    capacity: output of the number of bytes the returned buffer holds
+        /// @return   uint8_t*: the buffer to receive into
+        inline uint8_t *buffer_for(size_t message_size, size_t &capacity)
+        {
+            if (resize_container != nullptr && message_size > max_receive_size)
+            {
+                if (uint8_t *p_resized = resize_container(p_container, message_size); p_resized != nullptr)
+                {
+                    capacity = message_size;
+                    return p_resized;
+                }
+            }
+            capacity = max_receive_size;
+            return received_data;
+        }
+
+        /// @brief ends the receive of a message of "message_size" bytes, into a buffer holding "capacity" bytes, flagging it as
+        /// truncated if it didn't fit
+        inline void end_receive(size_t message_size, size_t capacity)
+        {
+            returned_recv_size = message_size < capacity ? message_size : capacity;
+            truncated          = message_size > capacity;
+            end_op(status_e::SUCCESS);
+        }
     };
 
     /// @brief the input arguments needed to perform a close operation
@@ -85,6 +135,62 @@ namespace interface
         open_op *p_open_op     = nullptr; // a pointer to an active open operation's arguments, or nullptr for no open operation
         close_op *p_close_op   = nullptr; // a pointer to an active close operation's arguments, or nullptr for no close operation
         bool idle_in_send_recv = false;   // set to true to wait (idle) in "process_send_receive", even if no operation is requested
+        bool poll_only         = false;   // true while driven by an external event loop (see poll_once), so the process_ methods must not block
+
+        /// @brief set by the backend to have "process_send_receive" called again by this time, even if no operation is requested,
+        /// for periodic work like keepalives or retransmits. It's a one-shot timer, that's reset to time_point::max() right before
+        /// the call it triggers, so the backend needs to set it again from there to keep ticking.
+        std::chrono::steady_clock::time_point next_wakeup = std::chrono::steady_clock::time_point::max();
+
+        /// @brief reads the clock that the operations' end_time were set from, which the factory sets to its clock policy, so
+        /// that every deadline is compared against the same clock (a coarse clock can lag the steady clock by a tick)
+        std::chrono::steady_clock::time_point (*read_clock)() noexcept = []() noexcept
+        { return std::chrono::steady_clock::now(); };
+
+        /// @brief returns the current time, from the clock the operations' end_time were set from
+        inline std::chrono::steady_clock::time_point now() const noexcept
+        {
+            return read_clock();
+        }
+
+        /// @brief returns true if next_wakeup has passed
+        inline bool is_wakeup_due(std::chrono::steady_clock::time_point now_time) const
+        {
+            return next_wakeup <= now_time;
+        }
+
+        /// @brief returns true if next_wakeup has passed, relative to the current time (see now())
+        inline bool is_wakeup_due() const
+        {
+            return is_wakeup_due(now());
+        }
+
+        /// @brief calculate the duration until "process_send_receive" needs to return, which is the earliest of the active
+        /// send/receive timeouts, and next_wakeup, relative to the passed absolute time
+        ///
+        /// @tparam   Dur: duration type to return
+        /// @param    now_time: the absolute time to calculate the duration relative to
+        /// @return   Dur: the duration of time until the next timeout or wakeup, 0 if it has already passed, or Dur::max() if there's
+        ///           nothing to wait for (so it should wait until woken by "wake_process")
+        template <typename Dur = std::chrono::nanoseconds>
+        Dur duration_until_wakeup(std::chrono::steady_clock::time_point now_time) const
+        {
+            auto min_time = Dur::max();
+            if (next_wakeup != std::chrono::steady_clock::time_point::max())
+                min_time = next_wakeup <= now_time ? Dur(0) : std::chrono::duration_cast<Dur>(next_wakeup - now_time);
+            for (const common_op *op_ptr : {static_cast<const common_op *>(p_send_op), static_cast<const common_op *>(p_recv_op)})
+                if (op_ptr != nullptr)
+                    min_time = std::min(min_time, op_ptr->template duration_until_timeout<Dur>(now_time));
+            return min_time;
+        }
+
+        /// @brief calculate the duration until "process_send_receive" needs to return, relative to the current time (see above,
+        /// and now())
+        template <typename Dur = std::chrono::nanoseconds>
+        Dur duration_until_wakeup() const
+        {
+            return duration_until_wakeup<Dur>(now());
+        }
 
         /// @brief calculate the smallest duration until the timeout of the passed operation pointers (which are allowed to be nullptr)
         /// relative to the passed absolute time
@@ -114,7 +220,7 @@ namespace interface
         }
 
         /// @brief calculate the smallest duration until the timeout of the passed operation pointers (which are allowed to be nullptr)
-        /// relative to the current time
+        /// relative to the current time of std::chrono::steady_clock (backends should pass "transactions.now()" instead)
         ///
         /// @tparam   Dur: duration type to return
         /// @tparam   NUM_OPS: number of operations to check
@@ -135,12 +241,74 @@ namespace interface
 
         /// @brief the number of bytes received
         size_t size;
+
+        /// @brief true if the message was larger than the buffer, so that only the first "size" bytes of it were received
+        bool truncated = false;
     };
 
     //// @brief used to specify that no open options are needed (allows open to be called without options immediately)
     struct no_opts
     {
     };
+
+    /// @brief what an external event loop needs to wait for, before calling poll_once on a raw interface
+    struct readiness_report
+    {
+        /// @brief the file descriptor to wait on, or -1 if the interface doesn't provide one (so it needs to be polled periodically)
+        int fd = -1;
+
+        /// @brief true if a receive is posted, so the loop should wait for the fd to be readable
+        bool readable = false;
+
+        /// @brief true if a send is posted, so the loop should wait for the fd to be writable
+        bool writable = false;
+
+        /// @brief when poll_once needs to be called by, even if the fd isn't ready, so that the posted operations can time out,
+        /// and the backend can do its periodic work
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    };
+
+    /// @brief a report of the memory and OS resources used by an interface, for capacity planning
+    struct footprint_report
+    {
+        /// @brief sizeof the interface's type, only filled in when reported by footprint_of or static_footprint
+        size_t object_size = 0u;
+
+        /// @brief the number of threads running for the interface (or the max number, for static_footprint)
+        size_t threads = 0u;
+
+        /// @brief the stack size requested for each of the interface's threads in bytes, 0 if the platform default is used
+        size_t thread_stack_size = 0u;
+
+        /// @brief the number of file descriptors held by the interface, only known at runtime
+        size_t fds = 0u;
+    };
+
+    /// @brief reports the compile-time footprint of an interface type
+    ///
+    /// @tparam   T: the interface type
+    /// @return   footprint_report: the object size, and the max number of threads each instance can run
+    template <typename T>
+    constexpr footprint_report static_footprint()
+    {
+        footprint_report report{};
+        report.object_size = sizeof(T);
+        report.threads     = T::threadsafe ? 1u : 0u;
+        return report;
+    }
+
+    /// @brief reports the runtime footprint of an interface, including the size of its type
+    ///
+    /// @tparam   T: the interface type
+    /// @param    conn: the interface to report on
+    /// @return   footprint_report: the resources currently used by the interface
+    template <typename T>
+    footprint_report footprint_of(const T &conn)
+    {
+        footprint_report report = conn.footprint();
+        report.object_size      = sizeof(T);
+        return report;
+    }
 } // namespace interface
 
 #endif // CPPTXRX_OP_TYPES_H_
\ No newline at end of file
@@ -0,0 +1,320 @@
+/// @file cpptxrx_policies.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines the compile-time policies used to configure "interface::factory", which is the base class behind
+/// "interface::thread_safe" and "interface::raw"
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_POLICIES_H_
+#define CPPTXRX_POLICIES_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <time.h>
+
+namespace interface
+{
+    namespace policy
+    {
+        // ----------------------------------------------------------------------------------------------------------------
+        // synchronization policies: pick who runs the process_ methods
+
+        /// @brief no synchronization, the process_ methods run directly on the thread that requests an operation, so only one
+        /// thread can use the interface at a time (this is what "interface::raw" uses)
+        struct unsynchronized
+        {
+            static constexpr bool threadsafe        = false;
+            static constexpr bool one_caller_per_op = false;
+        };
+
+        /// @brief the process_ methods run on a management thread, that any number of calling threads dispatch their operations
+        /// to (this is what "interface::thread_safe" uses)
+        struct management_thread
+        {
+            static constexpr bool threadsafe        = true;
+            static constexpr bool one_caller_per_op = false;
+        };
+
+        /// @brief like management_thread, but assumes that at most one thread at a time calls send, and at most one thread at a
+        /// time calls receive (like a dedicated sender and receiver thread). Sends and receives are then handed to the management
+        /// thread through lock-free slots (see cpptxrx_handoff.h) instead of the mutex and condition variable, and debug builds
+        /// assert that the contract is kept. The send queue depth is unused, since there's only ever one send to queue.
+        struct single_caller
+        {
+            static constexpr bool threadsafe        = true;
+            static constexpr bool one_caller_per_op = true;
+        };
+
+        // ----------------------------------------------------------------------------------------------------------------
+        // wait policies: pick how calling threads wait for the management thread (unused by unsynchronized interfaces)
+
+        /// @brief callers sleep on a condition variable until the management thread notifies them
+        struct blocking_wait
+        {
+            static constexpr size_t spins = 0u;
+
+            template <typename pred_type>
+            static void wait(std::unique_lock<std::mutex> &lk, std::condition_variable &cv, pred_type pred)
+            {
+                cv.wait(lk, pred);
+            }
+
+            template <typename pred_type>
+            static bool wait_until(std::unique_lock<std::mutex> &lk, std::condition_variable &cv,
+                                   std::chrono::steady_clock::time_point end_time, pred_type pred)
+            {
+                return cv.wait_until(lk, end_time, pred);
+            }
+        };
+
+        /// @brief callers yield and re-check up to "max_spins" times before sleeping on the condition variable, trading some
+        /// cpu time for a lower wake up latency when operations complete quickly (like in-process interfaces)
+        ///
+        /// @tparam   max_spins: how many times to yield before falling back to blocking_wait
+        template <size_t max_spins>
+        struct spin_then_block_wait
+        {
+            static constexpr size_t spins = max_spins;
+
+            template <typename pred_type>
+            static void wait(std::unique_lock<std::mutex> &lk, std::condition_variable &cv, pred_type pred)
+            {
+                for (size_t i = 0; i < max_spins; i++)
+                {
+                    if (pred())
+                        return;
+                    lk.unlock();
+                    std::this_thread::yield();
+                    lk.lock();
+                }
+                cv.wait(lk, pred);
+            }
+
+            template <typename pred_type>
+            static bool wait_until(std::unique_lock<std::mutex> &lk, std::condition_variable &cv,
+                                   std::chrono::steady_clock::time_point end_time, pred_type pred)
+            {
+                for (size_t i = 0; i < max_spins; i++)
+                {
+                    if (pred())
+                        return true;
+                    if (std::chrono::steady_clock::now() >= end_time)
+                        return false;
+                    lk.unlock();
+                    std::this_thread::yield();
+                    lk.lock();
+                }
+                return cv.wait_until(lk, end_time, pred);
+            }
+        };
+
+        // ----------------------------------------------------------------------------------------------------------------
+        // clock policies: pick the clock used for default timeouts, and for checking if an operation has timed out
+
+        /// @brief uses std::chrono::steady_clock directly
+        struct steady_clock
+        {
+            static std::chrono::steady_clock::time_point now() noexcept
+            {
+                return std::chrono::steady_clock::now();
+            }
+        };
+
+        /// @brief a cheaper, lower resolution (usually 1-4ms) version of the steady clock, for interfaces that check timeouts
+        /// very often, but don't need them to be precise. Falls back to std::chrono::steady_clock where it's not available.
+        struct coarse_steady_clock
+        {
+            static std::chrono::steady_clock::time_point now() noexcept
+            {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+                // std::chrono::steady_clock uses CLOCK_MONOTONIC on linux, which shares its epoch with CLOCK_MONOTONIC_COARSE
+                timespec ts{};
+                if (clock_gettime(CLOCK_MONOTONIC_COARSE, &ts) == 0)
+                    return std::chrono::steady_clock::time_point(
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+#endif
+                return std::chrono::steady_clock::now();
+            }
+        };
+
+        // ----------------------------------------------------------------------------------------------------------------
+        // timeout policies: pick the timeouts used when an operation is called without one
+
+        /// @brief the default timeouts
+        ///
+        /// @tparam   recv_ns (optional): default recv timeout in ns
+        /// @tparam   send_ns (optional): default send timeout in ns
+        /// @tparam   open_ns (optional): default open timeout in ns
+        /// @tparam   clse_ns (optional): default close timeout in ns
+        template <uint64_t recv_ns = std::chrono::nanoseconds(std::chrono::seconds(30)).count(),
+                  uint64_t send_ns = std::chrono::nanoseconds(std::chrono::seconds(1)).count(),
+                  uint64_t open_ns = std::chrono::nanoseconds(std::chrono::seconds(1)).count(),
+                  uint64_t clse_ns = std::chrono::nanoseconds(std::chrono::seconds(1)).count()>
+        struct timeouts
+        {
+            static constexpr uint64_t default_recv_timeout_ns = recv_ns;
+            static constexpr uint64_t default_send_timeout_ns = send_ns;
+            static constexpr uint64_t default_open_timeout_ns = open_ns;
+            static constexpr uint64_t default_clse_timeout_ns = clse_ns;
+        };
+
+        // ----------------------------------------------------------------------------------------------------------------
+        // direction policies: pick which of send and receive the interface supports, where the unsupported one returns
+        // status_e::UNSUPPORTED_OP right away, and is pruned from the management thread's dispatch
+
+        /// @brief supports both sending and receiving
+        struct bidirectional
+        {
+            static constexpr bool can_send    = true;
+            static constexpr bool can_receive = true;
+        };
+
+        /// @brief only supports sending (like an exporter)
+        struct send_only
+        {
+            static constexpr bool can_send    = true;
+            static constexpr bool can_receive = false;
+        };
+
+        /// @brief only supports receiving (like a listener)
+        struct receive_only
+        {
+            static constexpr bool can_send    = false;
+            static constexpr bool can_receive = true;
+        };
+
+        // ----------------------------------------------------------------------------------------------------------------
+        // dispatch policies: pick how the factory calls the backend's hooks (the process_ methods, wake_process, etc.)
+
+        /// @brief the hooks are virtual methods, and the interface inherits "interface::abstract" for polymorphism
+        struct dynamic_dispatch
+        {
+            static constexpr bool is_static = false;
+            using derived                   = void; // the hooks are called through the factory itself
+        };
+
+        /// @brief the hooks are resolved at compile-time through the final class (CRTP), so they can be inlined into the
+        /// management loop, and the interface doesn't inherit "interface::abstract" (wrap it in "interface::polymorphic" if
+        /// it's needed). The hooks are then plain methods, declared without virtual or override.
+        ///
+        /// @tparam   derived_type: the final interface class, that inherits from the factory
+        template <typename derived_type>
+        struct static_dispatch
+        {
+            static constexpr bool is_static = true;
+            using derived                   = derived_type;
+        };
+
+        // ----------------------------------------------------------------------------------------------------------------
+        // send order policies: pick the order that queued sends are handed to the process_ methods in (unused by unsynchronized
+        // and single_caller interfaces, which never have more than one send waiting)
+
+        /// @brief queued sends are sent first-in-first-out
+        struct fifo_send_order
+        {
+            static constexpr size_t heap_arity  = 0u;
+            static constexpr size_t high_weight = 0u;
+        };
+
+        /// @brief queued sends are sent earliest deadline first (their end_time), so that sends with tight deadlines don't sit
+        /// behind ones with loose deadlines, where any that can no longer meet their deadline are failed with
+        /// status_e::TIMED_OUT before reaching the process_ methods. Sends with the same deadline stay first-in-first-out.
+        ///
+        /// @tparam   arity (optional): the number of children per node of the d-ary heap the sends are queued in
+        template <size_t arity = 4>
+        struct deadline_send_order
+        {
+            static_assert(arity >= 2u, "a heap needs at least two children per node");
+            static constexpr size_t heap_arity  = arity;
+            static constexpr size_t high_weight = 0u;
+        };
+
+        /// @brief queued sends wait in one of two first-in-first-out lanes, picked by their priority (priority_e::HIGH or
+        /// priority_e::NORMAL), where the high priority lane is always served first, except that while both lanes have sends
+        /// waiting, every "weight" high priority sends are followed by one normal priority send, so that bulk traffic can't be
+        /// starved. Each lane can hold send_queue_depth sends, so that bulk traffic can't take the room of control traffic.
+        ///
+        /// @tparam   weight (optional): how many high priority sends are served for each normal priority send, when both wait
+        template <size_t weight = 8>
+        struct priority_send_order
+        {
+            static_assert(weight >= 1u, "the high priority lane needs a weight of at least one");
+            static constexpr size_t heap_arity  = 0u;
+            static constexpr size_t high_weight = weight;
+        };
+
+        // ----------------------------------------------------------------------------------------------------------------
+
+        /// @brief the full set of policies used by an "interface::factory", where each "with_" alias swaps out a single policy,
+        /// for example: "interface::policy::policies<>::with_wait<interface::policy::spin_then_block_wait<64>>"
+        ///
+        /// @tparam   sync_type (optional): the synchronization policy
+        /// @tparam   timeouts_type (optional): the default timeouts policy
+        /// @tparam   wait_type (optional): the wait policy
+        /// @tparam   clock_type (optional): the clock policy
+        /// @tparam   send_queue_depth_value (optional): how many sends can be queued behind the one being processed, so
+        ///           that the management thread can move straight on to the next one (unused by unsynchronized interfaces)
+        /// @tparam   direction_type (optional): the direction policy
+        /// @tparam   dispatch_type (optional): the dispatch policy
+        /// @tparam   send_order_type (optional): the send order policy
+        template <typename sync_type              = management_thread,
+                  typename timeouts_type          = timeouts<>,
+                  typename wait_type              = blocking_wait,
+                  typename clock_type             = steady_clock,
+                  size_t send_queue_depth_value   = 1,
+                  typename direction_type         = bidirectional,
+                  typename dispatch_type          = dynamic_dispatch,
+                  typename send_order_type        = fifo_send_order>
+        struct policies
+        {
+            static_assert(send_queue_depth_value > 0, "the send queue needs room for at least one send");
+            static_assert(direction_type::can_send || direction_type::can_receive, "an interface must be able to send or receive");
+
+            using sync                               = sync_type;
+            using timeouts                           = timeouts_type;
+            using wait                               = wait_type;
+            using clock                              = clock_type;
+            static constexpr size_t send_queue_depth = send_queue_depth_value;
+            using direction                          = direction_type;
+            using dispatch                           = dispatch_type;
+            using send_order                         = send_order_type;
+
+            template <typename new_sync_type>
+            using with_sync = policies<new_sync_type, timeouts_type, wait_type, clock_type, send_queue_depth_value, direction_type, dispatch_type, send_order_type>;
+
+            template <typename new_timeouts_type>
+            using with_timeouts = policies<sync_type, new_timeouts_type, wait_type, clock_type, send_queue_depth_value, direction_type, dispatch_type, send_order_type>;
+
+            template <typename new_wait_type>
+            using with_wait = policies<sync_type, timeouts_type, new_wait_type, clock_type, send_queue_depth_value, direction_type, dispatch_type, send_order_type>;
+
+            template <typename new_clock_type>
+            using with_clock = policies<sync_type, timeouts_type, wait_type, new_clock_type, send_queue_depth_value, direction_type, dispatch_type, send_order_type>;
+
+            template <size_t new_send_queue_depth>
+            using with_send_queue_depth = policies<sync_type, timeouts_type, wait_type, clock_type, new_send_queue_depth, direction_type, dispatch_type, send_order_type>;
+
+            template <typename new_direction_type>
+            using with_direction = policies<sync_type, timeouts_type, wait_type, clock_type, send_queue_depth_value, new_direction_type, dispatch_type, send_order_type>;
+
+            template <typename new_dispatch_type>
+            using with_dispatch = policies<sync_type, timeouts_type, wait_type, clock_type, send_queue_depth_value, direction_type, new_dispatch_type, send_order_type>;
+
+            template <typename new_send_order_type>
+            using with_send_order = policies<sync_type, timeouts_type, wait_type, clock_type, send_queue_depth_value, direction_type, dispatch_type, new_send_order_type>;
+        };
+
+        /// @brief the policies used by "interface::thread_safe"
+        using threadsafe_defaults = policies<management_thread>;
+
+        /// @brief the policies used by "interface::raw"
+        using raw_defaults = policies<unsynchronized>;
+    } // namespace policy
+} // namespace interface
+
+#endif // CPPTXRX_POLICIES_H_
@@ -1,13 +1,27 @@
 /// @file cpptxrx_raii_thread.h
 /// @author Darren V Levine (DarrenVLevine@gmail.com)
-/// @brief defines a RAII thread class that is the same as std::thread but will join the thread when destructed if it is joinable
+/// @brief defines a RAII thread class that is the same as std::thread but will join the thread when destructed if it is joinable,
+/// and a variant of it that can be started with a custom stack size
 ///
 /// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
 ///
 #ifndef CPPTXRX_RAII_THREAD_H_
 #define CPPTXRX_RAII_THREAD_H_
 
+#include <memory>
+#include <system_error>
 #include <thread>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<pthread.h>)
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#define CPPTXRX_HAS_PTHREAD 1
+#else
+#define CPPTXRX_HAS_PTHREAD 0
+#endif
 
 namespace interface
 {
@@ -36,6 +50,122 @@ namespace interface
                 join();
         }
     };
+
+    /// @brief like raii_thread, it joins the thread when destructed if it is joinable, but it can also be started with a custom
+    /// stack size. Uses pthreads if available, otherwise it falls back to std::thread and the stack size is ignored.
+    class sized_raii_thread
+    {
+    public:
+        sized_raii_thread() = default;
+
+        /// @brief starts a new thread
+        ///
+        /// @param    stack_size: the stack size for the thread in bytes, or 0 to use the platform default. Sizes below
+        ///           PTHREAD_STACK_MIN are rounded up to it, and sizes are rounded up to a whole number of pages.
+        /// @param    func: the callable to run in the new thread
+        template <typename F>
+        sized_raii_thread(size_t stack_size, F &&func)
+        {
+#if CPPTXRX_HAS_PTHREAD
+            using func_type = typename std::decay<F>::type;
+            auto p_func     = std::make_unique<func_type>(std::forward<F>(func));
+
+            pthread_attr_t attr;
+            int err = pthread_attr_init(&attr);
+            if (err != 0)
+                throw std::system_error(err, std::generic_category(), "sized_raii_thread failed to start");
+            if (stack_size != 0u)
+            {
+                const size_t min_size  = static_cast<size_t>(PTHREAD_STACK_MIN);
+                const long page_size   = sysconf(_SC_PAGESIZE);
+                const size_t page_mask = page_size > 0 ? static_cast<size_t>(page_size) - 1u : 0u;
+                stack_size             = stack_size < min_size ? min_size : stack_size;
+                stack_size             = (stack_size + page_mask) & ~page_mask;
+                err                    = pthread_attr_setstacksize(&attr, stack_size);
+            }
+            if (err == 0)
+                err = pthread_create(&handle, &attr, &run<func_type>, p_func.get());
+            pthread_attr_destroy(&attr);
+            if (err != 0)
+                throw std::system_error(err, std::generic_category(), "sized_raii_thread failed to start");
+
+            p_func.release(); // now owned by the new thread
+            started = true;
+#else
+            (void)stack_size;
+            handle = std::thread(std::forward<F>(func));
+#endif
+        }
+
+        sized_raii_thread(sized_raii_thread &&other) noexcept
+        {
+            swap(other);
+        }
+        inline sized_raii_thread &operator=(sized_raii_thread &&other)
+        {
+            if (joinable())
+                join();
+            swap(other);
+            return *this;
+        }
+        sized_raii_thread(const sized_raii_thread &)            = delete;
+        sized_raii_thread &operator=(const sized_raii_thread &) = delete;
+
+        /// @brief returns true if the thread was started and hasn't been joined yet
+        inline bool joinable() const noexcept
+        {
+#if CPPTXRX_HAS_PTHREAD
+            return started;
+#else
+            return handle.joinable();
+#endif
+        }
+
+        /// @brief waits for the thread to finish
+        inline void join()
+        {
+#if CPPTXRX_HAS_PTHREAD
+            if (!started)
+                throw std::system_error(std::make_error_code(std::errc::invalid_argument), "sized_raii_thread not joinable");
+            const int err = pthread_join(handle, nullptr);
+            if (err != 0)
+                throw std::system_error(err, std::generic_category(), "sized_raii_thread failed to join");
+            started = false;
+#else
+            handle.join();
+#endif
+        }
+
+        inline void swap(sized_raii_thread &other) noexcept
+        {
+            std::swap(handle, other.handle);
+#if CPPTXRX_HAS_PTHREAD
+            std::swap(started, other.started);
+#endif
+        }
+
+        inline ~sized_raii_thread()
+        {
+            if (joinable())
+                join();
+        }
+
+    private:
+#if CPPTXRX_HAS_PTHREAD
+        pthread_t handle{};
+        bool started{false};
+
+        template <typename func_type>
+        static void *run(void *p_func)
+        {
+            std::unique_ptr<func_type> owned_func(static_cast<func_type *>(p_func));
+            (*owned_func)();
+            return nullptr;
+        }
+#else
+        std::thread handle{};
+#endif
+    };
 } // namespace interface
 
 #endif // CPPTXRX_RAII_THREAD_H_
\ No newline at end of file
@@ -0,0 +1,216 @@
+/// @file cpptxrx_receive_ring.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines "interface::receive_ring", a ring of receive buffers that's registered with a threadsafe interface once, so
+/// that its management thread can keep filling them back-to-back, while the caller consumes the filled ones
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_RECEIVE_RING_H_
+#define CPPTXRX_RECEIVE_RING_H_
+
+#include "cpptxrx_buffer_pool.h"
+#include "cpptxrx_handoff.h"
+#include "cpptxrx_op_backend.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace interface
+{
+    /// @brief a filled slot of a receive ring
+    struct received_slot
+    {
+        uint8_t *data  = nullptr; // the received bytes
+        size_t size    = 0u;      // the number of bytes received
+        bool truncated = false;   // the message was larger than the slot, so only the start of it was received
+    };
+
+    /// @brief the non-templated part of a receive_ring, that interfaces are given by register_receive_ring. Slots are filled by
+    /// the interface's management thread, and consumed by a single caller thread, using release/acquire counters, so that
+    /// neither side takes a lock. The consumer only makes a system call if it has to sleep, or if the management thread ran out
+    /// of empty slots and needs to be told one was returned.
+    class receive_ring_base
+    {
+        // the counts of filled and consumed slots, each written by only one side, on its own cache line, and compared with
+        // wrapping arithmetic, where the matching slot indexes are tracked separately so that any number of slots works
+        alignas(cache_line_size) std::atomic<uint32_t> filled{0u}; // written by the management thread
+        size_t fill_index{0u};
+        alignas(cache_line_size) std::atomic<uint32_t> consumed{0u}; // written by the consumer
+        size_t consume_index{0u};
+        std::atomic<uint32_t> consumer_waiting{0u};
+
+        // written by both sides, but only when the management thread runs out of empty slots
+        alignas(cache_line_size) std::atomic<bool> producer_stalled{false};
+        void (*wake_producer)(void *) = nullptr;
+        void *p_producer              = nullptr;
+
+        received_slot *const slots;
+        uint8_t *const storage;
+        const size_t num_slots;
+        const size_t max_slot_size;
+
+        template <typename, typename>
+        friend class factory;
+
+        // ---------------------------------------- management thread side ----------------------------------------
+
+        /// @brief returns the buffer of the next empty slot, or nullptr if every slot is full, in which case the consumer wakes
+        /// the management thread (through wake_producer) once it returns one
+        [[nodiscard]] uint8_t *next_empty() noexcept
+        {
+            const uint32_t next = filled.load(std::memory_order_relaxed);
+            if (next - consumed.load(std::memory_order_acquire) < num_slots)
+                return storage + fill_index * max_slot_size;
+
+            // flag the stall, and then re-check, in case a slot was returned before the consumer could have seen the flag
+            producer_stalled.store(true, std::memory_order_seq_cst);
+            if (next - consumed.load(std::memory_order_seq_cst) < num_slots)
+            {
+                producer_stalled.store(false, std::memory_order_relaxed);
+                return storage + fill_index * max_slot_size;
+            }
+            return nullptr;
+        }
+
+        /// @brief hands the slot returned by next_empty to the consumer, waking it if it's asleep
+        ///
+        /// @param    size: the number of bytes received into it
+        /// @param    truncated: true if the message didn't fit in the slot
+        void fill(size_t size, bool truncated) noexcept
+        {
+            slots[fill_index] = {storage + fill_index * max_slot_size, size, truncated};
+            fill_index        = (fill_index + 1u) % num_slots;
+            filled.store(filled.load(std::memory_order_relaxed) + 1u, std::memory_order_seq_cst);
+            if (consumer_waiting.load(std::memory_order_seq_cst) != 0u)
+                futex_wake_all(filled);
+        }
+
+        /// @brief sets the method the consumer calls to wake the management thread, after returning a slot while it's stalled
+        void attach(void (*wake)(void *), void *p_context) noexcept
+        {
+            wake_producer = wake;
+            p_producer    = p_context;
+            producer_stalled.store(false, std::memory_order_relaxed);
+        }
+
+    protected:
+        receive_ring_base(received_slot *p_slots, uint8_t *p_storage, size_t slot_count, size_t slot_size) noexcept
+            : slots(p_slots), storage(p_storage), num_slots(slot_count), max_slot_size(slot_size)
+        {
+        }
+
+    public:
+        receive_ring_base(const receive_ring_base &)            = delete;
+        receive_ring_base &operator=(const receive_ring_base &) = delete;
+
+        /// @brief returns the number of slots in the ring
+        [[nodiscard]] size_t capacity() const noexcept { return num_slots; }
+
+        /// @brief returns the max number of bytes received into each slot
+        [[nodiscard]] size_t slot_size() const noexcept { return max_slot_size; }
+
+        /// @brief returns the number of filled slots waiting to be consumed
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return filled.load(std::memory_order_acquire) - consumed.load(std::memory_order_relaxed);
+        }
+
+        // ---------------------------------------- consumer side ----------------------------------------
+
+        /// @brief returns the oldest filled slot without waiting, which stays valid until pop() is called
+        ///
+        /// @return   const received_slot*: the oldest filled slot, or nullptr if there isn't one
+        [[nodiscard]] const received_slot *front() noexcept
+        {
+            if (filled.load(std::memory_order_acquire) == consumed.load(std::memory_order_relaxed))
+                return nullptr;
+            return &slots[consume_index];
+        }
+
+        /// @brief waits for the oldest filled slot, which stays valid until pop() is called
+        ///
+        /// @param    timeout: the longest time to wait for
+        /// @return   const received_slot*: the oldest filled slot, or nullptr if the timeout passed first
+        [[nodiscard]] const received_slot *wait_front(std::chrono::nanoseconds timeout) noexcept
+        {
+            const auto now      = std::chrono::steady_clock::now();
+            const auto end_time = timeout >= std::chrono::steady_clock::time_point::max() - now
+                                      ? std::chrono::steady_clock::time_point::max()
+                                      : now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+            while (true)
+            {
+                if (const received_slot *p_slot = front(); p_slot != nullptr)
+                    return p_slot;
+
+                // let the management thread know it needs to wake this thread, before checking one last time and sleeping
+                consumer_waiting.store(1u, std::memory_order_seq_cst);
+                const uint32_t seen  = filled.load(std::memory_order_seq_cst);
+                const auto remaining = end_time - std::chrono::steady_clock::now();
+                if (seen == consumed.load(std::memory_order_relaxed))
+                {
+                    if (remaining <= std::chrono::steady_clock::duration::zero())
+                    {
+                        consumer_waiting.store(0u, std::memory_order_relaxed);
+                        return nullptr;
+                    }
+                    futex_wait(filled, seen, remaining);
+                }
+                consumer_waiting.store(0u, std::memory_order_relaxed);
+            }
+        }
+
+        /// @brief returns the oldest filled slot to the management thread to be filled again, there must be a filled slot
+        void pop() noexcept
+        {
+            consume_index = (consume_index + 1u) % num_slots;
+            consumed.store(consumed.load(std::memory_order_relaxed) + 1u, std::memory_order_seq_cst);
+            if (producer_stalled.exchange(false, std::memory_order_seq_cst) && wake_producer != nullptr)
+                wake_producer(p_producer);
+        }
+    };
+
+    /// @brief a ring of "num_buffers" receive buffers of "buffer_size" bytes each, that's registered with a threadsafe interface
+    /// using register_receive_ring, after which its management thread keeps receiving into the empty buffers back-to-back, which
+    /// keeps the socket drained even while the consumer is briefly busy, and removes the per-receive handshake with the
+    /// management thread. Only one thread may consume from it at a time.
+    ///
+    /// @tparam   num_buffers: the number of receive buffers
+    /// @tparam   buffer_size: the max number of bytes received into each buffer
+    template <size_t num_buffers, size_t buffer_size>
+    class receive_ring : public receive_ring_base
+    {
+        static_assert(num_buffers > 0u && num_buffers <= UINT32_MAX / 2u, "the ring needs at least one buffer");
+        static_assert(buffer_size > 0u, "the buffers need room for at least one byte");
+
+        received_slot slot_infos[num_buffers]      = {};
+        uint8_t buffers[num_buffers * buffer_size] = {};
+
+    public:
+        receive_ring() noexcept : receive_ring_base(slot_infos, buffers, num_buffers, buffer_size) {}
+    };
+
+    /// @brief holds the slot infos of a pooled_receive_ring, as a base class so that they're created before the ring
+    struct pooled_receive_ring_slots
+    {
+        std::unique_ptr<received_slot[]> slot_infos;
+    };
+
+    /// @brief a receive ring whose buffers are the buffers of a buffer_pool, so that they can be backed by huge pages, and
+    /// placed on the NUMA node of the management thread that fills them (see buffer_pool), where one slot is used per buffer
+    class pooled_receive_ring : private pooled_receive_ring_slots, public receive_ring_base
+    {
+    public:
+        /// @brief creates a ring over every buffer of the pool
+        ///
+        /// @param    pool: the pool, which must outlive the ring
+        explicit pooled_receive_ring(const buffer_pool &pool)
+            : pooled_receive_ring_slots{std::unique_ptr<received_slot[]>(new received_slot[pool.buffer_count()])},
+              receive_ring_base(slot_infos.get(), pool.buffer(0u), pool.buffer_count(), pool.buffer_size())
+        {
+        }
+    };
+} // namespace interface
+
+#endif // CPPTXRX_RECEIVE_RING_H_
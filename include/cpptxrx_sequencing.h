@@ -0,0 +1,205 @@
+/// @file cpptxrx_sequencing.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines "interface::sequencing", a decorator that numbers every message sent, and counts the messages that were
+/// lost, duplicated, or reordered on the way to the receiver
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_SEQUENCING_H_
+#define CPPTXRX_SEQUENCING_H_
+
+#include "cpptxrx_decorator.h"
+#include "cpptxrx_op_backend.h"
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace interface
+{
+    /// @brief the counts of the messages received by a sequencing decorator
+    struct sequence_stats
+    {
+        uint64_t received   = 0u; // messages received with a sequence number
+        uint64_t lost       = 0u; // sequence numbers skipped over, minus the ones that arrived late since
+        uint64_t duplicates = 0u; // messages whose sequence number was already received
+        uint64_t reordered  = 0u; // messages that arrived after a message with a later sequence number
+        uint64_t restarts   = 0u; // messages too far behind to classify, which the numbering restarted from (a sender restart)
+        uint64_t malformed  = 0u; // messages too short to hold a sequence number, which were dropped
+    };
+
+    /// @brief a decorator that appends a 4 byte sequence number to every message sent, and removes it from every message
+    /// received, counting gaps, duplicates, and out of order arrivals along the way, so that kernel drops, network loss, and
+    /// reordering can be told apart. A message too far behind the highest one received to be classified restarts the numbering
+    /// from it, like after the sender restarted. Every message is still delivered, in the order it arrived, and its sequence
+    /// number is available from last_sequence(). Any number of threads may send at a time, where each send reserves its number with an
+    /// atomic increment, and no lock is held while it's sent. A failed send gives its number back, so that it isn't counted as
+    /// lost, unless a later send has already reserved the next one, in which case the gap is counted as lost. Concurrent sends
+    /// can reach the wire in a different order than they were numbered in, which is counted as reordered. Only one thread may
+    /// receive at a time. The per-message cost is a copy onto the stack, an atomic increment, and a few bit operations, so it
+    /// can stay on.
+    ///
+    /// @tparam   max_message_size: the largest message that can be sent (see decorator::send_with_trailer)
+    template <size_t max_message_size = 1472u>
+    class sequencing : public decorator
+    {
+        static constexpr uint32_t window_size = 64u;
+
+        alignas(cache_line_size) std::atomic<uint32_t> next_send{0u};
+
+        alignas(cache_line_size) std::atomic<uint64_t> received{0u};
+        std::atomic<uint64_t> lost{0u};
+        std::atomic<uint64_t> duplicates{0u};
+        std::atomic<uint64_t> reordered{0u};
+        std::atomic<uint64_t> restarts{0u};
+        std::atomic<uint64_t> malformed{0u};
+
+        // the highest sequence number received, and a bit per sequence number below it, where bit i is set if highest - i
+        // was received
+        uint32_t highest  = 0u;
+        uint64_t seen     = 0u;
+        uint32_t last_seq = 0u;
+        bool started      = false;
+
+        static inline void store_sequence(uint8_t *p, uint32_t sequence) noexcept
+        {
+            for (size_t i = 0; i < sequence_size; i++)
+                p[i] = static_cast<uint8_t>(sequence >> (8u * i));
+        }
+        static inline uint32_t load_sequence(const uint8_t *p) noexcept
+        {
+            uint32_t sequence = 0u;
+            for (size_t i = 0; i < sequence_size; i++)
+                sequence |= static_cast<uint32_t>(p[i]) << (8u * i);
+            return sequence;
+        }
+
+        /// @brief classifies a received sequence number against the ones received before it
+        void track(uint32_t sequence) noexcept
+        {
+            increment(received);
+            if (!started)
+            {
+                started = true;
+                highest = sequence;
+                seen    = 1u;
+                return;
+            }
+
+            // compared with wrapping arithmetic, so the numbering can run forever
+            const int32_t ahead = static_cast<int32_t>(sequence - highest);
+            if (ahead > 0)
+            {
+                const uint32_t skipped = static_cast<uint32_t>(ahead);
+                seen                   = (skipped >= window_size ? 0u : seen << skipped) | 1u;
+                highest                = sequence;
+                if (skipped > 1u)
+                    increment(lost, skipped - 1u);
+                return;
+            }
+
+            // too far behind to be told apart from a duplicate, which only a sender restart does, so the numbering restarts
+            // from it rather than counting every later message against the old numbering
+            const uint32_t behind = static_cast<uint32_t>(-static_cast<int64_t>(ahead));
+            if (behind >= window_size)
+            {
+                increment(restarts);
+                highest = sequence;
+                seen    = 1u;
+                return;
+            }
+            const uint64_t bit = uint64_t{1u} << behind;
+            if ((seen & bit) != 0u)
+            {
+                increment(duplicates);
+                return;
+            }
+            seen |= bit;
+            increment(reordered);
+            if (const uint64_t current_lost = lost.load(std::memory_order_relaxed); current_lost > 0u)
+                lost.store(current_lost - 1u, std::memory_order_relaxed);
+        }
+
+        /// @brief removes and tracks the sequence number of a received message
+        ///
+        /// @return   true: if the message is malformed, and should be dropped
+        bool drop_if_malformed(const uint8_t *data, recv_ret &result) noexcept
+        {
+            if (!received_whole(result))
+                return false;
+            if (result.size < sequence_size)
+            {
+                increment(malformed);
+                return true;
+            }
+            result.size -= sequence_size;
+            last_seq = load_sequence(data + result.size);
+            track(last_seq);
+            return false;
+        }
+
+        status_e send_numbered(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking,
+                               priority_e priority)
+        {
+            const uint32_t sequence = next_send.fetch_add(1u, std::memory_order_relaxed);
+            auto append_sequence    = [sequence](uint8_t *framed, size_t message_size)
+            { store_sequence(framed + message_size, sequence); };
+            const status_e status = send_with_trailer<max_message_size, sequence_size>(data, size, end_time, blocking, priority, append_sequence);
+            if (status != status_e::SUCCESS)
+            {
+                // only given back if no later send has reserved a number since, which would otherwise be reused
+                uint32_t reserved_next = sequence + 1u;
+                next_send.compare_exchange_strong(reserved_next, sequence, std::memory_order_relaxed);
+            }
+            return status;
+        }
+
+        recv_ret receive_numbered(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, bool blocking)
+        {
+            return receive_until_kept(data, size, end_time, blocking, [this](const uint8_t *message, recv_ret &result)
+                                      { return drop_if_malformed(message, result); });
+        }
+
+    public:
+        /// @brief the number of bytes added to the end of every message
+        static constexpr size_t sequence_size = 4u;
+
+        using decorator::decorator;
+        using decorator::receive;
+        using decorator::send;
+
+        /// @brief returns the counts of the messages received so far
+        [[nodiscard]] sequence_stats stats() const noexcept
+        {
+            sequence_stats report{};
+            report.received   = received.load(std::memory_order_relaxed);
+            report.lost       = lost.load(std::memory_order_relaxed);
+            report.duplicates = duplicates.load(std::memory_order_relaxed);
+            report.reordered  = reordered.load(std::memory_order_relaxed);
+            report.restarts   = restarts.load(std::memory_order_relaxed);
+            report.malformed  = malformed.load(std::memory_order_relaxed);
+            return report;
+        }
+
+        /// @brief returns the sequence number of the last message received, which should only be called by the receiving thread
+        [[nodiscard]] uint32_t last_sequence() const noexcept { return last_seq; }
+
+        status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time, priority_e priority) override
+        {
+            return send_numbered(data, size, end_time, true, priority);
+        }
+        recv_ret receive(uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time) override
+        {
+            return receive_numbered(data, size, end_time, true);
+        }
+        status_e try_send(const uint8_t *const data, size_t size) override
+        {
+            return send_numbered(data, size, std::chrono::steady_clock::time_point::max(), false, priority_e::NORMAL);
+        }
+        recv_ret try_receive(uint8_t *const data, size_t size) override
+        {
+            return receive_numbered(data, size, std::chrono::steady_clock::time_point::max(), false);
+        }
+    };
+} // namespace interface
+
+#endif // CPPTXRX_SEQUENCING_H_
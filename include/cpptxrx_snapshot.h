@@ -0,0 +1,137 @@
+/// @file cpptxrx_snapshot.h
+/// @author Darren V Levine (DarrenVLevine@gmail.com)
+/// @brief defines a "snapshot" type used to publish a copy of a value from one thread, so that it can be read from other threads
+/// without the readers ever blocking the writer or each other
+///
+/// @copyright (c) 2024 Darren V Levine. This code is licensed under MIT license (see LICENSE file for details).
+///
+#ifndef CPPTXRX_SNAPSHOT_H_
+#define CPPTXRX_SNAPSHOT_H_
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <type_traits>
+
+namespace interface
+{
+    /// @brief a seqlock protected copy of a trivially copyable value. Readers retry if a write happened while they
+    /// were copying, so they never block the writer, and writers are only serialized against other writers.
+    ///
+    /// @tparam   T: the trivially copyable type to hold
+    template <typename T>
+    class seqlock_snapshot
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "seqlock_snapshot requires a trivially copyable type");
+
+        // the value is held as an array of atomic words, so that copying it while a write is in progress isn't a data race
+        static constexpr size_t NUM_WORDS = (sizeof(T) + sizeof(uint64_t) - 1u) / sizeof(uint64_t);
+
+        std::atomic<uint64_t> sequence{0u}; // odd while a write is in progress
+        std::atomic<uint64_t> words[NUM_WORDS]{};
+
+    public:
+        seqlock_snapshot() = default;
+        explicit seqlock_snapshot(const T &initial_value)
+        {
+            store(initial_value);
+        }
+
+        /// @brief publishes a new copy of the value
+        ///
+        /// @param    value: the value to publish
+        void store(const T &value) noexcept
+        {
+            uint64_t buffer[NUM_WORDS] = {};
+            memcpy(buffer, &value, sizeof(T));
+
+            // acquire the write side by moving the sequence from even to odd
+            uint64_t seq = sequence.load(std::memory_order_relaxed);
+            do
+            {
+                while ((seq & 1u) != 0u)
+                {
+                    std::this_thread::yield();
+                    seq = sequence.load(std::memory_order_relaxed);
+                }
+            } while (!sequence.compare_exchange_weak(seq, seq + 1u, std::memory_order_relaxed, std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (size_t i = 0; i < NUM_WORDS; i++)
+                words[i].store(buffer[i], std::memory_order_relaxed);
+
+            // release the write side, making the new value visible to readers
+            sequence.store(seq + 2u, std::memory_order_release);
+        }
+
+        /// @brief reads a consistent copy of the most recently published value
+        ///
+        /// @param    out_value: where the copy will be written
+        void load(T &out_value) const noexcept
+        {
+            uint64_t buffer[NUM_WORDS];
+            uint64_t seq_before;
+            uint64_t seq_after;
+            do
+            {
+                seq_before = sequence.load(std::memory_order_acquire);
+                while ((seq_before & 1u) != 0u)
+                {
+                    std::this_thread::yield();
+                    seq_before = sequence.load(std::memory_order_acquire);
+                }
+                for (size_t i = 0; i < NUM_WORDS; i++)
+                    buffer[i] = words[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                seq_after = sequence.load(std::memory_order_relaxed);
+            } while (seq_before != seq_after);
+            memcpy(static_cast<void *>(&out_value), buffer, sizeof(T));
+        }
+    };
+
+    /// @brief a mutex protected copy of a value, used for types that can't be copied word by word. Readers only
+    /// block for as long as it takes to copy the value.
+    ///
+    /// @tparam   T: the copyable type to hold
+    template <typename T>
+    class locked_snapshot
+    {
+        mutable std::mutex m{};
+        T value{};
+
+    public:
+        locked_snapshot() = default;
+        explicit locked_snapshot(const T &initial_value) : value(initial_value) {}
+
+        /// @brief publishes a new copy of the value
+        ///
+        /// @param    new_value: the value to publish
+        void store(const T &new_value)
+        {
+            std::lock_guard<std::mutex> lk(m);
+            value = new_value;
+        }
+
+        /// @brief reads a copy of the most recently published value
+        ///
+        /// @param    out_value: where the copy will be written
+        void load(T &out_value) const
+        {
+            std::lock_guard<std::mutex> lk(m);
+            out_value = value;
+        }
+    };
+
+    /// @brief a published copy of a value, that other threads can read without blocking the thread that publishes it,
+    /// which uses a seqlock for trivially copyable types, and otherwise falls back to a short mutex protected copy
+    ///
+    /// @tparam   T: the type to hold
+    template <typename T>
+    using snapshot = typename std::conditional<std::is_trivially_copyable<T>::value,
+                                               seqlock_snapshot<T>,
+                                               locked_snapshot<T>>::type;
+} // namespace interface
+
+#endif // CPPTXRX_SNAPSHOT_H_
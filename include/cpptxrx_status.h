@@ -39,7 +39,13 @@ namespace interface
             IN_PROGRESS = -7,
 
             /// @brief call ".get_error_code()" and/or ".c_str()" to get error info for this interface specific error
-            SEE_ERROR_CODE = -8
+            SEE_ERROR_CODE = -8,
+
+            /// @brief the operation isn't supported by the interface, like a receive on a send-only interface
+            UNSUPPORTED_OP = -9,
+
+            /// @brief the operation couldn't be done right away without blocking, like posting a send while another is still posted
+            WOULD_BLOCK = -10
         };
 
         // the following static constexpr values are duplicated and exposed to appear like an enum class' value
@@ -60,6 +66,10 @@ namespace interface
         static constexpr standard_status_e IN_PROGRESS = standard_status_e::IN_PROGRESS;
         /// @brief call ".get_error_code()" and/or ".c_str()" to get error info for this interface specific error
         static constexpr standard_status_e SEE_ERROR_CODE = standard_status_e::SEE_ERROR_CODE;
+        /// @brief the operation isn't supported by the interface, like a receive on a send-only interface
+        static constexpr standard_status_e UNSUPPORTED_OP = standard_status_e::UNSUPPORTED_OP;
+        /// @brief the operation couldn't be done right away without blocking, like posting a send while another is still posted
+        static constexpr standard_status_e WOULD_BLOCK = standard_status_e::WOULD_BLOCK;
 
         /// @brief constructs a new status_e object using one of the standard status values as the default
         inline constexpr status_e(standard_status_e val) : value(static_cast<int>(val)) {}
@@ -116,6 +126,10 @@ namespace interface
                 // this is here for completeness, unless the user explicitly set SEE_ERROR_CODE,
                 // which is not a good practice, they should get error_num_str instead
                 return "SEE_ERROR_CODE";
+            case static_cast<int>(standard_status_e::UNSUPPORTED_OP):
+                return "UNSUPPORTED_OP";
+            case static_cast<int>(standard_status_e::WOULD_BLOCK):
+                return "WOULD_BLOCK";
             default:
                 if (error_num_str != nullptr)
                     return error_num_str;   // if a custom error code was used
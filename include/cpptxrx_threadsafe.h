@@ -7,13 +7,7 @@
 #ifndef CPPTXRX_THREADSAFE_H_
 #define CPPTXRX_THREADSAFE_H_
 
-// the following macro manipulation imports (or re-imports) "cpptxrx_factory.h" but with the threadsafe features/overhead turned on
-#define CPPTXRX_THREADSAFE 1
-#ifdef CPPTXRX_FACTORY_H_
-#undef CPPTXRX_FACTORY_H_
-#endif
 #include "cpptxrx_factory.h"
-#undef CPPTXRX_THREADSAFE
 
 namespace interface
 {
@@ -34,6 +28,50 @@ namespace interface
                                            default_send_timeout_ns,
                                            default_open_timeout_ns,
                                            default_clse_timeout_ns>;
+
+    /// @brief a inheritable base class for creating thread safe CppTxRx interfaces, that are only ever used by at most one sending
+    /// thread and at most one receiving thread at a time (which debug builds assert). Sends and receives are handed to the management
+    /// thread lock-free, so they have a much lower overhead than interface::thread_safe (see interface::policy::single_caller).
+    ///
+    /// @tparam   open_opts_type: options type to use when calling "open"
+    /// @tparam   default_recv_timeout_ns (optional): default recv timeout in ns
+    /// @tparam   default_send_timeout_ns (optional): default send timeout in ns
+    /// @tparam   default_open_timeout_ns (optional): default open timeout in ns
+    /// @tparam   default_clse_timeout_ns (optional): default close timeout in ns
+    template <typename open_opts_type,
+              uint64_t default_recv_timeout_ns = std::chrono::nanoseconds(std::chrono::seconds(30)).count(),
+              uint64_t default_send_timeout_ns = std::chrono::nanoseconds(std::chrono::seconds(1)).count(),
+              uint64_t default_open_timeout_ns = std::chrono::nanoseconds(std::chrono::seconds(1)).count(),
+              uint64_t default_clse_timeout_ns = std::chrono::nanoseconds(std::chrono::seconds(1)).count()>
+    using thread_safe_spsc = spsc_threadsafe_factory<open_opts_type,
+                                                     default_recv_timeout_ns,
+                                                     default_send_timeout_ns,
+                                                     default_open_timeout_ns,
+                                                     default_clse_timeout_ns>;
+
+    /// @brief a inheritable base class for creating thread safe CppTxRx interfaces, whose hooks (the process_ methods, wake_process,
+    /// etc.) are resolved statically, using the CRTP pattern, so they can be inlined into the management loop (see
+    /// interface::policy::static_dispatch). The hooks are then declared without virtual or override, and the interface doesn't
+    /// inherit interface::abstract, unless it's wrapped in interface::polymorphic.
+    ///
+    /// @tparam   derived_type: the interface class that inherits from this
+    /// @tparam   open_opts_type: options type to use when calling "open"
+    /// @tparam   default_recv_timeout_ns (optional): default recv timeout in ns
+    /// @tparam   default_send_timeout_ns (optional): default send timeout in ns
+    /// @tparam   default_open_timeout_ns (optional): default open timeout in ns
+    /// @tparam   default_clse_timeout_ns (optional): default close timeout in ns
+    template <typename derived_type,
+              typename open_opts_type,
+              uint64_t default_recv_timeout_ns = std::chrono::nanoseconds(std::chrono::seconds(30)).count(),
+              uint64_t default_send_timeout_ns = std::chrono::nanoseconds(std::chrono::seconds(1)).count(),
+              uint64_t default_open_timeout_ns = std::chrono::nanoseconds(std::chrono::seconds(1)).count(),
+              uint64_t default_clse_timeout_ns = std::chrono::nanoseconds(std::chrono::seconds(1)).count()>
+    using thread_safe_static = static_threadsafe_factory<derived_type,
+                                                         open_opts_type,
+                                                         default_recv_timeout_ns,
+                                                         default_send_timeout_ns,
+                                                         default_open_timeout_ns,
+                                                         default_clse_timeout_ns>;
 } // namespace interface
 
 #endif // CPPTXRX_THREADSAFE_H_
@@ -12,19 +12,55 @@
 
 namespace udp
 {
-    /// @brief a thread-safe udp socket
-    class socket : public interface::thread_safe<opts>
+    /// @brief a thread-safe udp socket, that can be restricted to only sending, or only receiving
+    ///
+    /// @tparam   direction_type: one of the interface::policy direction policies (bidirectional, send_only, or receive_only)
+    template <typename direction_type>
+    class basic_socket : public interface::factory<opts, interface::policy::threadsafe_defaults::with_direction<direction_type>>
     {
+        using base_type = interface::factory<opts, interface::policy::threadsafe_defaults::with_direction<direction_type>>;
+
     public:
-        IMPORT_CPPTXRX_CTOR_AND_DTOR(socket);
+        using base_type::can_receive;
+        using base_type::can_send;
+        using base_type::construct;
+        using base_type::destroy;
+        using base_type::open;
+        using base_type::threadsafe;
 
-        [[nodiscard]] virtual const char *name() const override { return "udp::socket"; }
+        IMPORT_CPPTXRX_CTOR_AND_DTOR(basic_socket);
+
+        [[nodiscard]] virtual const char *name() const override
+        {
+            if constexpr (!can_receive)
+                return "udp::sender";
+            else if constexpr (!can_send)
+                return "udp::listener";
+            else
+                return "udp::socket";
+        }
         [[nodiscard]] virtual int id() const override { return 0x4208; }
 
+        /// @brief returns the number of coalesced sends dropped, since their datagram failed to send transiently (see
+        /// opts::coalesce)
+        [[nodiscard]] uint64_t coalesced_sends_dropped() const { return utils.coalesced_drops.load(std::memory_order_relaxed); }
+
     protected:
         friend struct socket_utilities;
         socket_utilities utils = {};
 
+        size_t fds_used() const override
+        {
+            return utils.fds_open.load(std::memory_order_relaxed);
+        }
+        bool process_try_send(interface::send_op &op) override
+        {
+            return can_send && utils.try_send(*this, op);
+        }
+        bool process_try_receive(interface::recv_op &op) override
+        {
+            return can_receive && utils.try_receive(*this, op);
+        }
         void construct() override
         {
             utils.construct<true>();
@@ -43,12 +79,21 @@ namespace udp
         }
         void process_send_receive() override
         {
-            utils.process_send_receive<true>(*this);
+            utils.process_send_receive<true, can_send, can_receive>(*this);
         }
         void wake_process() override
         {
             utils.wake_process();
         }
     };
+
+    /// @brief a thread-safe udp socket
+    using socket = basic_socket<interface::policy::bidirectional>;
+
+    /// @brief a thread-safe udp socket that can only send (like an exporter), where receive returns status_e::UNSUPPORTED_OP
+    using sender = basic_socket<interface::policy::send_only>;
+
+    /// @brief a thread-safe udp socket that can only receive (like a listener), where send returns status_e::UNSUPPORTED_OP
+    using listener = basic_socket<interface::policy::receive_only>;
 } // namespace udp
 #endif // CPPTXRX_UDP_H_
\ No newline at end of file
@@ -7,13 +7,17 @@
 #ifndef CPPTXRX_UDP_RAW_H_
 #define CPPTXRX_UDP_RAW_H_
 
+#include "cpptxrx_fd_waiter.h"
 #include "cpptxrx_raw.h"
 #include <arpa/inet.h>
+#include <atomic>
 #include <cstring>
 #include <errno.h>
+#include <memory>
 #include <signal.h>
-#include <sys/eventfd.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <type_traits>
 #include <unistd.h>
 
 namespace udp
@@ -25,16 +29,40 @@ namespace udp
         SERVER
     };
 
-    /// @brief UDP socket options
+    /// @brief the largest payload that fits in a single UDP datagram
+    constexpr size_t MAX_DATAGRAM_SIZE = 65507u;
+
+    /// @brief UDP socket options. Note that receive_into peeks the size of each datagram first (with MSG_PEEK | MSG_TRUNC),
+    /// so it costs one extra system call per receive, compared with receiving into a fixed size buffer.
     struct opts
     {
-        role_e m_role              = role_e::CLIENT;
-        uint16_t m_port            = 0;
-        int m_domain               = -1;
-        sockaddr_storage m_address = {};
-        socklen_t m_address_size   = 0;
+        role_e m_role                               = role_e::CLIENT;
+        uint16_t m_port                             = 0;
+        int m_domain                                = -1;
+        sockaddr_storage m_address                  = {};
+        socklen_t m_address_size                    = 0;
+        size_t m_coalesce_size                      = 0u; // 0 when sends aren't coalesced
+        std::chrono::microseconds m_coalesce_budget = {};
 
         CPPTXRX_OPTS_SETTER(role);
+
+        /// @brief packs consecutive small sends into a single datagram, each framed with a 1-3 byte length prefix, which is
+        /// sent once it's full, or once the first send in it has waited for the latency budget. Sends complete as soon as
+        /// they're packed. The receiving socket must also coalesce, so that it unpacks each datagram, and each receive still
+        /// returns one send. If sending a datagram fails transiently (like ENOBUFS, when the send queue is full), the sends packed
+        /// in it are dropped, and counted by coalesced_sends_dropped(), while any other error closes the socket. Note that raw
+        /// interfaces only send a datagram that's waiting on its latency budget during their
+        /// next operation, or poll_once (see readiness().deadline).
+        ///
+        /// @param    max_datagram_size: the size of the datagrams to pack sends into (up to MAX_DATAGRAM_SIZE), where larger
+        ///           sends are sent on their own, or 0 to stop coalescing
+        /// @param    latency_budget: the longest time a send can wait to be packed with the sends after it
+        inline opts &coalesce(size_t max_datagram_size, std::chrono::microseconds latency_budget)
+        {
+            m_coalesce_size   = max_datagram_size < MAX_DATAGRAM_SIZE ? max_datagram_size : MAX_DATAGRAM_SIZE;
+            m_coalesce_budget = latency_budget;
+            return *this;
+        }
         inline opts &port(uint16_t v)
         {
             m_port = v;
@@ -72,22 +100,164 @@ namespace udp
         }
     };
 
+    /// @brief the buffers and framing used to coalesce small sends into datagrams, and to unpack them (see opts::coalesce),
+    /// where each message is prefixed with its length as a little endian base 128 varint (1 byte for up to 127 bytes)
+    struct coalescer
+    {
+        std::unique_ptr<uint8_t[]> tx_buffer{};
+        std::unique_ptr<uint8_t[]> rx_buffer{};
+        size_t tx_capacity                                = 0u;
+        size_t tx_size                                    = 0u;
+        size_t tx_count                                   = 0u; // the number of sends packed
+        std::chrono::steady_clock::time_point tx_deadline = {}; // when the packed sends need to be sent by
+        sockaddr_storage tx_address                       = {}; // where the packed sends are going
+        socklen_t tx_address_size                         = 0;
+        size_t rx_size                                    = 0u;
+        size_t rx_offset                                  = 0u; // the start of the next message to unpack
+
+        static constexpr size_t MAX_HEADER_SIZE = 3u;
+
+        [[nodiscard]] inline bool enabled() const noexcept { return tx_capacity > 0u; }
+        [[nodiscard]] inline bool has_tx() const noexcept { return tx_size > 0u; }
+        [[nodiscard]] inline bool has_rx() const noexcept { return rx_offset < rx_size; }
+
+        static inline size_t header_size(size_t size) noexcept
+        {
+            return size < (1u << 7) ? 1u : (size < (1u << 14) ? 2u : 3u);
+        }
+
+        static inline size_t write_header(uint8_t *p_out, size_t size) noexcept
+        {
+            size_t i = 0u;
+            while (size >= 0x80u)
+            {
+                p_out[i++] = static_cast<uint8_t>(size | 0x80u);
+                size >>= 7;
+            }
+            p_out[i++] = static_cast<uint8_t>(size);
+            return i;
+        }
+
+        /// @brief allocates the buffers, or frees them if coalescing is disabled, meant to be called when opening
+        void reset(size_t capacity)
+        {
+            tx_capacity = capacity;
+            tx_size     = 0u;
+            tx_count    = 0u;
+            rx_size     = 0u;
+            rx_offset   = 0u;
+            tx_buffer.reset(capacity > 0u ? new uint8_t[capacity] : nullptr);
+            rx_buffer.reset(capacity > 0u ? new uint8_t[MAX_DATAGRAM_SIZE] : nullptr);
+        }
+
+        /// @brief drops any packed sends, and unpacked messages, meant to be called when closing
+        inline void discard() noexcept
+        {
+            tx_size   = 0u;
+            tx_count  = 0u;
+            rx_size   = 0u;
+            rx_offset = 0u;
+        }
+
+        /// @brief returns true if a send is small enough to ever be packed
+        [[nodiscard]] inline bool can_pack(size_t size) const noexcept
+        {
+            return header_size(size) + size <= tx_capacity;
+        }
+
+        /// @brief returns true if a send can be packed with the ones already waiting
+        [[nodiscard]] bool fits(size_t size, const sockaddr_storage &address, socklen_t address_size) const noexcept
+        {
+            if (header_size(size) + size > tx_capacity - tx_size)
+                return false;
+            return tx_size == 0u || (address_size == tx_address_size && memcmp(&address, &tx_address, static_cast<size_t>(address_size)) == 0);
+        }
+
+        /// @brief packs a send, which must fit
+        ///
+        /// @param    deadline: when the packed sends need to be sent by, if this is the first one (the end of its latency budget)
+        /// @return   true: if it was the first send packed, so its deadline was used
+        bool pack(const uint8_t *data, size_t size, const sockaddr_storage &address, socklen_t address_size,
+                  std::chrono::steady_clock::time_point deadline)
+        {
+            const bool first = tx_size == 0u;
+            if (first)
+            {
+                tx_deadline     = deadline;
+                tx_address      = address;
+                tx_address_size = address_size;
+            }
+            tx_size += write_header(tx_buffer.get() + tx_size, size);
+            memcpy(tx_buffer.get() + tx_size, data, size);
+            tx_size += size;
+            tx_count++;
+            return first;
+        }
+
+        /// @brief returns true if the packed sends need to be sent now, since no other message could fit
+        [[nodiscard]] inline bool is_full() const noexcept
+        {
+            return tx_capacity - tx_size < 2u;
+        }
+
+        /// @brief unpacks the next received message into a receive operation, growing its container, or truncating it, if it
+        /// doesn't fit
+        void unpack(interface::recv_op &op)
+        {
+            size_t size  = 0u;
+            size_t shift = 0u;
+            while (rx_offset < rx_size && shift < 7u * MAX_HEADER_SIZE)
+            {
+                const uint8_t byte = rx_buffer[rx_offset++];
+                size |= static_cast<size_t>(byte & 0x7Fu) << shift;
+                shift += 7u;
+                if ((byte & 0x80u) == 0u)
+                {
+                    if (size <= rx_size - rx_offset)
+                    {
+                        size_t capacity    = 0u;
+                        uint8_t *p_output = op.buffer_for(size, capacity);
+                        memcpy(p_output, rx_buffer.get() + rx_offset, size < capacity ? size : capacity);
+                        rx_offset += size;
+                        op.end_receive(size, capacity);
+                        return;
+                    }
+                    break;
+                }
+            }
+            rx_offset = rx_size; // drop the rest of a malformed datagram
+            op.end_op_with_error_code(EBADMSG, "MALFORMED_COALESCED_DATAGRAM");
+        }
+    };
+
     struct socket_utilities
     {
-        int socket_wake_fd = -1;
-        int socket_fd      = -1;
+        interface::fd_waiter waiter           = {};
+        int socket_fd                         = -1;
+        bool rx_ready                         = false; // socket_fd may have a datagram to receive, until a receive would block
+        bool tx_ready                         = false; // socket_fd may have room for a send, until a send would block
+        interface::priority_e socket_priority = interface::priority_e::NORMAL; // the priority socket_fd marks datagrams with
+        coalescer coalesced                   = {};
+
+        // the number of open fds, tracked atomically so that it can be reported from any thread by fds_used()
+        std::atomic<size_t> fds_open{0u};
+
+        // the number of packed sends dropped by transient send errors, reported by coalesced_sends_dropped()
+        std::atomic<uint64_t> coalesced_drops{0u};
+
+        void update_fds_open()
+        {
+            fds_open.store(static_cast<size_t>(socket_fd >= 0) + waiter.fds_used(), std::memory_order_relaxed);
+        }
 
         template <bool threadsafe>
         void construct()
         {
             signal(SIGPIPE, SIG_IGN);
 
-            if constexpr (threadsafe)
-            {
-                socket_wake_fd = eventfd(0, EFD_NONBLOCK);
-                if (socket_wake_fd < 0)
-                    raise(SIGSEGV);
-            }
+            if (!waiter.construct(threadsafe))
+                raise(SIGSEGV);
+            update_fds_open();
         }
 
         template <bool threadsafe>
@@ -96,17 +266,16 @@ namespace udp
             if (socket_fd != -1 && ::close(socket_fd) == -1)
                 raise(SIGSEGV);
 
-            if constexpr (threadsafe)
-            {
-                if (socket_wake_fd != -1 && ::close(socket_wake_fd) != 0)
-                    raise(SIGSEGV);
-            }
+            if (!waiter.destruct())
+                raise(SIGSEGV);
+            fds_open.store(0u, std::memory_order_relaxed);
         }
 
         bool close_socket(interface::status_e &m_open_status)
         {
             if (socket_fd == -1)
                 return true;
+            waiter.remove(socket_fd);
             if (::close(socket_fd) == -1)
             {
                 m_open_status.set_error_code(static_cast<unsigned int>(errno), "CLOSE_ERR");
@@ -114,18 +283,20 @@ namespace udp
             }
             m_open_status = interface::status_e::NOT_OPEN;
             socket_fd     = -1;
+            coalesced.discard();
+            update_fds_open();
             return true;
         }
 
         void wake_process()
         {
-            uint64_t val = 1;
-            if (::write(socket_wake_fd, &val, sizeof(val)) != sizeof(val))
+            if (!waiter.wake())
                 raise(SIGSEGV);
         }
 
         void process_close(interface::transactions_args<opts> &conn)
         {
+            send_coalesced(conn); // best effort, since it's closing anyway
             if (close_socket(conn.m_open_status))
                 conn.transactions.p_close_op->end_op(interface::status_e::SUCCESS);
             else
@@ -148,6 +319,7 @@ namespace udp
                 socket_fd = ::socket(conn.m_open_opts.m_domain, SOCK_DGRAM, 0);
                 if (socket_fd < 0)
                     conn.transactions.p_open_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SOCK_CREATE_FAILURE");
+                update_fds_open();
             }
 
             if (conn.transactions.p_open_op->status != interface::status_e::IN_PROGRESS)
@@ -169,133 +341,330 @@ namespace udp
                 return;
             }
 
+            // registered once, edge triggered, so changing which operations are active never needs another system call.
+            // Readiness is tracked by rx_ready/tx_ready instead, which are only cleared once a transfer would block.
+            rx_ready        = true;
+            tx_ready        = true;
+            socket_priority = interface::priority_e::NORMAL;
+            coalesced.reset(conn.m_open_opts.m_coalesce_size);
+            if (!waiter.add(socket_fd, EPOLLIN | EPOLLOUT | EPOLLET))
+            {
+                conn.transactions.p_open_op->end_op_with_error_code(static_cast<unsigned int>(errno), "EPOLL_ADD_FAILURE");
+                close_socket(conn.m_open_status);
+                return;
+            }
+
             conn.transactions.p_open_op->end_op(interface::status_e::SUCCESS);
         }
 
-        template <bool threadsafe>
-        void process_send_receive(interface::transactions_args<opts> &conn)
-        {
-            // convert min_timeout to timeval
-            auto min_timeout = conn.transactions.duration_until_timeout({conn.transactions.p_recv_op, conn.transactions.p_send_op});
-            auto seconds     = std::chrono::duration_cast<std::chrono::seconds>(min_timeout);
-            if (seconds > min_timeout)
-                seconds -= std::chrono::seconds{1};
-            timeval tv;
-            tv.tv_sec  = seconds.count();
-            tv.tv_usec = std::chrono::duration_cast<std::chrono::microseconds>(min_timeout - seconds).count();
-
-            const bool receiving = conn.transactions.p_recv_op != nullptr;
-            const bool sending   = conn.transactions.p_send_op != nullptr;
-
-            fd_set read_fds;
-            FD_ZERO(&read_fds);
-            if constexpr (threadsafe)
-                FD_SET(socket_wake_fd, &read_fds);
-            if (receiving)
-                FD_SET(socket_fd, &read_fds);
-
-            fd_set write_fds;
-            if (sending)
+        /// @brief marks the datagrams sent next with the send's priority, as the socket's SO_PRIORITY (for the local queueing
+        /// discipline), and its DSCP (for the network), where high priority sends use expedited forwarding. It's best effort, since
+        /// a datagram is still worth sending with the default marking, and the options are only set when the priority changes.
+        void apply_priority(interface::transactions_args<opts> &conn, interface::priority_e priority)
+        {
+            if (priority == socket_priority)
+                return;
+            socket_priority = priority;
+
+            const bool high       = priority == interface::priority_e::HIGH;
+            const int so_priority = high ? 6 : 0;         // TC_PRIO_INTERACTIVE
+            const int tos         = high ? (46 << 2) : 0; // DSCP 46 (expedited forwarding), shifted past the ECN bits
+            if (conn.m_open_opts.m_domain == AF_INET6)
+                setsockopt(socket_fd, IPPROTO_IPV6, IPV6_TCLASS, &tos, sizeof(tos));
+            setsockopt(socket_fd, IPPROTO_IP, IP_TOS, &tos, sizeof(tos)); // also covers ipv4 mapped addresses on ipv6 sockets
+            // set last, since setting IP_TOS also resets SO_PRIORITY to one derived from the TOS bits
+            setsockopt(socket_fd, SOL_SOCKET, SO_PRIORITY, &so_priority, sizeof(so_priority));
+        }
+
+        /// @brief returns true if an errno means a non-blocking call had nothing it could do right away
+        static constexpr bool is_would_block(int error_code)
+        {
+#if EAGAIN == EWOULDBLOCK
+            return error_code == EAGAIN;
+#else
+            return error_code == EAGAIN || error_code == EWOULDBLOCK;
+#endif
+        }
+
+        /// @brief returns true if an errno means a send failed for now, but the socket is still usable
+        static constexpr bool is_transient(int error_code)
+        {
+            return is_would_block(error_code) || error_code == ENOBUFS || error_code == ENOMEM;
+        }
+
+        /// @brief sends the packed sends as one datagram, if there are any (see opts::coalesce)
+        ///
+        /// @return   false: if the send failed with a non-transient error, and the socket was closed
+        bool send_coalesced(interface::transactions_args<opts> &conn)
+        {
+            if (!coalesced.has_tx())
+                return true;
+            apply_priority(conn, interface::priority_e::NORMAL);
+            ssize_t send_size = -1;
+            do
+                send_size = ::sendto(socket_fd, coalesced.tx_buffer.get(), coalesced.tx_size, 0,
+                                     reinterpret_cast<sockaddr *>(&coalesced.tx_address), coalesced.tx_address_size);
+            while (send_size < 0 && errno == EINTR);
+            const bool sent     = send_size == static_cast<ssize_t>(coalesced.tx_size);
+            const size_t packed = coalesced.tx_count;
+            coalesced.tx_size   = 0u;
+            coalesced.tx_count  = 0u;
+            if (sent)
+                return true;
+
+            // the packed sends already succeeded, so a transient error can only drop them, and any other error can only be
+            // reported through the open status
+            if (send_size >= 0 || is_transient(errno))
             {
-                FD_ZERO(&write_fds);
-                FD_SET(socket_fd, &write_fds);
+                coalesced_drops.fetch_add(packed, std::memory_order_relaxed);
+                return true;
             }
+            const auto error_code = static_cast<unsigned int>(errno);
+            close_socket(conn.m_open_status);
+            conn.m_open_status.set_error_code(error_code, "COALESCED_SENDTO_FAILED");
+            return false;
+        }
 
-            fd_set except_fds;
-            FD_ZERO(&except_fds);
-            FD_SET(socket_fd, &except_fds);
-            if constexpr (threadsafe)
-                FD_SET(socket_wake_fd, &except_fds);
-
-            int maxfd  = socket_fd > socket_wake_fd ? socket_fd : socket_wake_fd;
-            int events = ::select(maxfd + 1, &read_fds, sending ? &write_fds : NULL, &except_fds, &tv);
+        /// @brief sends a datagram holding the send's data, framed as a single message if coalescing (see opts::coalesce)
+        ///
+        /// @return   true: if the whole send was sent
+        bool send_datagram(interface::transactions_args<opts> &conn, const interface::send_op &op, int flags)
+        {
+            apply_priority(conn, op.priority);
+            if (!coalesced.enabled())
+                return ::sendto(socket_fd, op.send_data, op.send_size, flags, reinterpret_cast<sockaddr *>(&conn.m_open_opts.m_address),
+                                conn.m_open_opts.m_address_size) == static_cast<ssize_t>(op.send_size);
+
+            uint8_t header[coalescer::MAX_HEADER_SIZE];
+            iovec iov[2]       = {{header, coalescer::write_header(header, op.send_size)},
+                                  {const_cast<uint8_t *>(op.send_data), op.send_size}};
+            msghdr msg         = {};
+            msg.msg_name       = &conn.m_open_opts.m_address;
+            msg.msg_namelen    = conn.m_open_opts.m_address_size;
+            msg.msg_iov        = iov;
+            msg.msg_iovlen     = 2;
+            return ::sendmsg(socket_fd, &msg, flags) == static_cast<ssize_t>(iov[0].iov_len + op.send_size);
+        }
 
-            // check for a timeout
-            if (events == 0)
-                return;
+        /// @brief receives a datagram into the receive operation, or into the buffer that it's unpacked from if coalescing
+        ///
+        /// @return   true: if a datagram was received
+        bool receive_datagram(interface::transactions_args<opts> &conn, interface::recv_op &op, int flags)
+        {
+            uint8_t *p_buffer  = coalesced.rx_buffer.get();
+            size_t buffer_size = MAX_DATAGRAM_SIZE;
+            if (!coalesced.enabled())
+            {
+                // peek the size of the next datagram first, if the receive can grow its container to fit it
+                ssize_t next_size = 0;
+                if (op.resize_container != nullptr)
+                {
+                    next_size = ::recvfrom(socket_fd, nullptr, 0u, flags | MSG_PEEK | MSG_TRUNC, nullptr, nullptr);
+                    if (next_size < 0)
+                        return false;
+                }
+                p_buffer = op.buffer_for(static_cast<size_t>(next_size), buffer_size);
+            }
 
-            // check for a select error
-            if (events < 0)
+            // with MSG_TRUNC, the full size of the datagram is returned, even if it was truncated to fit the buffer
+            auto read_size = ::recvfrom(socket_fd, p_buffer, buffer_size, flags | MSG_TRUNC,
+                                        reinterpret_cast<sockaddr *>(&conn.m_open_opts.m_address), &conn.m_open_opts.m_address_size);
+            if (read_size < 0)
+                return false;
+            if (coalesced.enabled())
             {
-                if (sending)
-                    conn.transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_ERROR_IN_TX");
-                if (receiving)
-                    conn.transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_ERROR_IN_RX");
-                close_socket(conn.m_open_status);
-                return;
+                coalesced.rx_size   = static_cast<size_t>(read_size) < MAX_DATAGRAM_SIZE ? static_cast<size_t>(read_size) : MAX_DATAGRAM_SIZE;
+                coalesced.rx_offset = 0u;
+                coalesced.unpack(op);
             }
+            else
+                op.end_receive(static_cast<size_t>(read_size), buffer_size);
+            return true;
+        }
 
-            // check for a socket exception
-            if (FD_ISSET(socket_fd, &except_fds))
+        /// @brief attempts a send once without blocking, for process_try_send
+        bool try_send(interface::transactions_args<opts> &conn, interface::send_op &op)
+        {
+            if (coalesced.enabled())
+                return false; // packing needs the management thread to send on the latency budget, so use the regular path
+            if (send_datagram(conn, op, MSG_DONTWAIT))
+                op.end_op(interface::status_e::SUCCESS);
+            else if (is_would_block(errno))
+                op.end_op(interface::status_e::WOULD_BLOCK);
+            else
             {
-                if (sending)
-                    conn.transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_SOCK_EXCEPTION_IN_TX");
-                if (receiving)
-                    conn.transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_SOCK_EXCEPTION_IN_RX");
+                op.end_op_with_error_code(static_cast<unsigned int>(errno), "SENDTO_FAILED");
                 close_socket(conn.m_open_status);
-                return;
             }
+            return true;
+        }
 
-            // check for a eventfd exception
-            if constexpr (threadsafe)
-                if (FD_ISSET(socket_wake_fd, &except_fds))
+        /// @brief attempts a receive once without blocking, for process_try_receive
+        bool try_receive(interface::transactions_args<opts> &conn, interface::recv_op &op)
+        {
+            if (coalesced.has_rx())
+                coalesced.unpack(op);
+            else if (!receive_datagram(conn, op, MSG_DONTWAIT))
+            {
+                if (is_would_block(errno))
+                    op.end_op(interface::status_e::WOULD_BLOCK);
+                else
                 {
-                    if (sending)
-                        conn.transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_EFD_EXCEPTION_IN_TX");
-                    if (receiving)
-                        conn.transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SELECT_EFD_EXCEPTION_IN_RX");
+                    op.end_op_with_error_code(static_cast<unsigned int>(errno), "RECVFROM_FAILED");
                     close_socket(conn.m_open_status);
-                    return;
                 }
+            }
+            return true;
+        }
 
-            // check to see if wake_process() was called
-            if constexpr (threadsafe)
-                if (FD_ISSET(socket_wake_fd, &read_fds))
+        /// @brief serves the active send/receive operations, where can_send/can_receive should match the interface's direction
+        /// policy, so that a unidirectional interface only ever waits for the readiness it can use. The interface is passed as
+        /// its own type (usually *this), so that sync_send_receive() is resolved statically, since the factory's is final.
+        template <bool threadsafe, bool can_send = true, bool can_receive = true, typename conn_type>
+        void process_send_receive(conn_type &conn)
+        {
+            static_assert(std::is_base_of<interface::transactions_args<opts>, conn_type>::value, "conn must be a udp interface");
+            // send any packed sends that have used up their latency budget, or make sure to be called again when they do
+            if (coalesced.has_tx())
+            {
+                if (conn.transactions.now() >= coalesced.tx_deadline)
                 {
-                    uint64_t val;
-                    if (::read(socket_wake_fd, &val, sizeof(val)) == -1)
-                    {
-                        if (sending)
-                            conn.transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "EFD_READ_ERR_IN_TX");
-                        if (receiving)
-                            conn.transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "EFD_READ_ERR_IN_RX");
-                        close_socket(conn.m_open_status);
+                    if (!send_coalesced(conn))
                         return;
-                    }
                 }
+                else
+                    conn.transactions.next_wakeup = std::min(conn.transactions.next_wakeup, coalesced.tx_deadline);
+            }
 
-            // check to see if the socket has data to be received
-            if (receiving && FD_ISSET(socket_fd, &read_fds))
+            // keep serving sends and receives in this one call, handing back finished operations and picking up new ones
+            // each time the wait wakes, until there's nothing left to wait on, an open/close/destroy is requested, or the
+            // next wakeup is due (so that whatever set it gets called again)
+            while (wait_and_transfer<threadsafe, can_send, can_receive>(conn) &&
+                   !conn.transactions.is_wakeup_due() && conn.sync_send_receive())
+            {
+            }
+        }
+
+        /// @brief packs a normal priority send that's small enough, and unpacks the next message of a received datagram
+        ///
+        /// @return   true: if either operation was served
+        template <bool can_send, bool can_receive>
+        bool serve_coalesced(interface::transactions_args<opts> &conn)
+        {
+            bool served = false;
+            if constexpr (can_send)
             {
-                auto read_size = ::recvfrom(socket_fd, conn.transactions.p_recv_op->received_data, conn.transactions.p_recv_op->max_receive_size,
-                                            0, reinterpret_cast<sockaddr *>(&conn.m_open_opts.m_address), &conn.m_open_opts.m_address_size);
-                if (read_size >= 0)
+                interface::send_op *p_op = conn.transactions.p_send_op;
+                if (p_op != nullptr && p_op->priority == interface::priority_e::NORMAL && coalesced.can_pack(p_op->send_size))
                 {
-                    conn.transactions.p_recv_op->status             = interface::status_e::SUCCESS;
-                    conn.transactions.p_recv_op->returned_recv_size = static_cast<size_t>(read_size);
+                    // the packed sends going elsewhere, or without room for this one, need to be sent first
+                    if (!coalesced.fits(p_op->send_size, conn.m_open_opts.m_address, conn.m_open_opts.m_address_size) &&
+                        !send_coalesced(conn))
+                    {
+                        p_op->end_op(conn.m_open_status); // the error that closed the socket
+                        return true;
+                    }
+                    if (coalesced.pack(p_op->send_data, p_op->send_size, conn.m_open_opts.m_address, conn.m_open_opts.m_address_size,
+                                       conn.transactions.now() + conn.m_open_opts.m_coalesce_budget))
+                        conn.transactions.next_wakeup = std::min(conn.transactions.next_wakeup, coalesced.tx_deadline);
+                    p_op->end_op(interface::status_e::SUCCESS);
+                    if (coalesced.is_full() && !send_coalesced(conn))
+                        return true;
+                    served = true;
                 }
-                else
+            }
+            if constexpr (can_receive)
+            {
+                if (conn.transactions.p_recv_op != nullptr && coalesced.has_rx())
                 {
-                    conn.transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "RECVFROM_FAILED");
-                    close_socket(conn.m_open_status);
-                    return;
+                    coalesced.unpack(*conn.transactions.p_recv_op);
+                    served = true;
+                }
+            }
+            return served;
+        }
+
+        /// @brief waits for the socket to be ready for the active send/receive operations, and then performs them
+        /// @return   false: if the socket had an error and was closed
+        template <bool threadsafe, bool can_send, bool can_receive>
+        bool wait_and_transfer(interface::transactions_args<opts> &conn)
+        {
+            const bool receiving = can_receive && conn.transactions.p_recv_op != nullptr;
+            const bool sending   = can_send && conn.transactions.p_send_op != nullptr;
+
+            // when coalescing, small sends are packed, and received messages are unpacked, without waiting on the socket
+            if (coalesced.enabled() && (sending || receiving) && serve_coalesced<can_send, can_receive>(conn))
+                return conn.m_open_status == interface::status_e::SUCCESS;
+
+            auto end_ops_with_error = [&](const char *&&tx_error, const char *&&rx_error)
+            {
+                if (sending)
+                    conn.transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), std::move(tx_error));
+                if (receiving)
+                    conn.transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), std::move(rx_error));
+                close_socket(conn.m_open_status);
+                return false;
+            };
+
+            // only wait when none of the active operations can make progress, since the socket is edge triggered
+            if (!(receiving && rx_ready) && !(sending && tx_ready))
+            {
+                // wait until the next timeout or wakeup, or wake_process() is called
+                epoll_event events[1];
+                int num_ready = waiter.wait(conn.transactions, events);
+
+                // check for a timeout, or wake_process() being called
+                if (num_ready == 0)
+                    return true;
+
+                // check for a wait error
+                if (num_ready < 0)
+                    return end_ops_with_error("EPOLL_ERROR_IN_TX", "EPOLL_ERROR_IN_RX");
+
+                // a socket error makes it both readable and writable, so that the error is returned by recvfrom or sendto
+                const uint32_t ready = events[0].events;
+                const bool errored   = (ready & (EPOLLERR | EPOLLHUP)) != 0u;
+                rx_ready             = rx_ready || errored || (ready & EPOLLIN) != 0u;
+                tx_ready             = tx_ready || errored || (ready & EPOLLOUT) != 0u;
+            }
+
+            // check to see if the socket has data to be received
+            if (receiving && rx_ready)
+            {
+                if (!receive_datagram(conn, *conn.transactions.p_recv_op, MSG_DONTWAIT))
+                {
+                    if (is_would_block(errno))
+                        rx_ready = false;
+                    else
+                    {
+                        conn.transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "RECVFROM_FAILED");
+                        close_socket(conn.m_open_status);
+                        return false;
+                    }
                 }
             }
 
             // check to see if the socket is ready for a send
-            if (sending && FD_ISSET(socket_fd, &write_fds))
+            if (sending && tx_ready)
             {
-                ssize_t send_size = ::sendto(socket_fd, conn.transactions.p_send_op->send_data, conn.transactions.p_send_op->send_size,
-                                             0, reinterpret_cast<sockaddr *>(&conn.m_open_opts.m_address), conn.m_open_opts.m_address_size);
-                if (send_size == static_cast<ssize_t>(conn.transactions.p_send_op->send_size))
+                // keep the packed sends ahead of this one, which is too big, or too important, to be packed
+                if (!send_coalesced(conn))
+                {
+                    conn.transactions.p_send_op->end_op(conn.m_open_status); // the error that closed the socket
+                    return false;
+                }
+                if (send_datagram(conn, *conn.transactions.p_send_op, MSG_DONTWAIT))
                     conn.transactions.p_send_op->end_op(interface::status_e::SUCCESS);
+                else if (is_would_block(errno))
+                    tx_ready = false;
                 else
                 {
-                    conn.transactions.p_recv_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SENDTO_FAILED");
+                    conn.transactions.p_send_op->end_op_with_error_code(static_cast<unsigned int>(errno), "SENDTO_FAILED");
                     close_socket(conn.m_open_status);
-                    return;
+                    return false;
                 }
             }
+            return true;
         }
     };
 
@@ -308,10 +677,30 @@ namespace udp
         [[nodiscard]] virtual const char *name() const override { return "udp::socket_raw"; }
         [[nodiscard]] virtual int id() const override { return 0x0B83; }
 
+        /// @brief returns the number of coalesced sends dropped, since their datagram failed to send transiently (see
+        /// opts::coalesce)
+        [[nodiscard]] uint64_t coalesced_sends_dropped() const { return utils.coalesced_drops.load(std::memory_order_relaxed); }
+
     protected:
         friend struct socket_utilities;
         socket_utilities utils = {};
 
+        size_t fds_used() const override
+        {
+            return utils.fds_open.load(std::memory_order_relaxed);
+        }
+        int readiness_fd() const override
+        {
+            return utils.socket_fd;
+        }
+        bool process_try_send(interface::send_op &op) override
+        {
+            return utils.try_send(*this, op);
+        }
+        bool process_try_receive(interface::recv_op &op) override
+        {
+            return utils.try_receive(*this, op);
+        }
         void construct() override
         {
             utils.construct<false>();
@@ -0,0 +1,137 @@
+#include "../examples/utils/printing.h"
+#include "../include/cpptxrx_threadsafe.h"
+#include <atomic>
+#include <list>
+
+// An in-memory interface, where every operation completes immediately, so that the benchmark only measures the
+// overhead of the threadsafe handshake between the calling threads and the management thread.
+template <typename base_type>
+class null_interface : public base_type
+{
+public:
+    // the base is a dependent type, so the names used by the import macros need to be brought in explicitly
+    using typename base_type::opts;
+    using base_type::construct;
+    using base_type::destroy;
+    using base_type::open;
+    using base_type::threadsafe;
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(null_interface);
+
+    [[nodiscard]] virtual const char *name() const override { return "null_interface"; }
+
+protected:
+    using base_type::transactions;
+
+    void process_close() override
+    {
+        transactions.p_close_op->end_op();
+    }
+    void process_open() override
+    {
+        transactions.p_open_op->end_op();
+    }
+    void process_send_receive() override
+    {
+        if (transactions.p_send_op != nullptr)
+            transactions.p_send_op->end_op();
+        if (transactions.p_recv_op != nullptr)
+            transactions.p_recv_op->end_op();
+    }
+    void wake_process() override
+    {
+    }
+};
+
+// the same in-memory interface, but with its hooks resolved statically (CRTP), so that they're inlined into the management loop
+class static_null_interface
+    : public interface::factory<interface::no_opts,
+                                interface::policy::policies<interface::policy::single_caller>::with_dispatch<interface::policy::static_dispatch<static_null_interface>>>
+{
+public:
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(static_null_interface);
+
+    [[nodiscard]] const char *name() const { return "static_null_interface"; }
+
+protected:
+    void process_close()
+    {
+        transactions.p_close_op->end_op();
+    }
+    void process_open()
+    {
+        transactions.p_open_op->end_op();
+    }
+    void process_send_receive()
+    {
+        if (transactions.p_send_op != nullptr)
+            transactions.p_send_op->end_op();
+        if (transactions.p_recv_op != nullptr)
+            transactions.p_recv_op->end_op();
+    }
+    void wake_process()
+    {
+    }
+};
+
+template <typename interface_type>
+static void run_contention_case(const char *label, size_t num_senders, size_t num_readers, std::chrono::milliseconds duration)
+{
+    interface_type conn;
+    if (conn.open() != interface::status_e::SUCCESS)
+    {
+        thread_printf("failed to open the null interface\n");
+        exit(EXIT_FAILURE);
+    }
+
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> total_sends{0};
+    std::atomic<uint64_t> total_reads{0};
+    {
+        std::list<interface::raii_thread> threads;
+        for (size_t i = 0; i < num_senders; i++)
+            threads.emplace_back(
+                [&]()
+                {
+                    const uint8_t tx_data[] = "x";
+                    uint64_t sends          = 0;
+                    while (running.load(std::memory_order_relaxed))
+                        sends += conn.send(tx_data) == interface::status_e::SUCCESS;
+                    total_sends += sends;
+                });
+        for (size_t i = 0; i < num_readers; i++)
+            threads.emplace_back(
+                [&]()
+                {
+                    uint64_t reads = 0;
+                    while (running.load(std::memory_order_relaxed))
+                        reads += conn.is_open();
+                    total_reads += reads;
+                });
+        std::this_thread::sleep_for(duration);
+        running = false;
+    }
+
+    const double seconds = std::chrono::duration<double>(duration).count();
+    thread_printf("| %-16s | senders=%2zu readers=%2zu | %12.0f sends/s | %12.0f is_open/s |\n",
+                  label, num_senders, num_readers, static_cast<double>(total_sends.load()) / seconds,
+                  static_cast<double>(total_reads.load()) / seconds);
+}
+
+using threadsafe_null_interface = null_interface<interface::thread_safe<interface::no_opts>>;
+using spsc_null_interface       = null_interface<interface::thread_safe_spsc<interface::no_opts>>;
+
+int main()
+{
+    thread_printf("Contention benchmark (cache line size = %zu bytes, sizeof(null_interface) = %zu bytes)\n",
+                  interface::cache_line_size, sizeof(threadsafe_null_interface));
+    const auto duration = std::chrono::milliseconds(500);
+    for (size_t senders : {1u, 2u, 4u})
+        for (size_t readers : {0u, 2u})
+            run_contention_case<threadsafe_null_interface>("thread_safe", senders, readers, duration);
+
+    // only a single sender is allowed with thread_safe_spsc
+    for (size_t readers : {0u, 2u})
+        run_contention_case<spsc_null_interface>("thread_safe_spsc", 1u, readers, duration);
+    for (size_t readers : {0u, 2u})
+        run_contention_case<static_null_interface>("spsc_static", 1u, readers, duration);
+}
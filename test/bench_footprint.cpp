@@ -0,0 +1,103 @@
+#include "../examples/utils/printing.h"
+#include "../include/default_udp.h"
+#include <list>
+
+// An in-memory interface, where every operation completes immediately, so that the benchmark only measures the
+// memory used by the interfaces and their management threads
+template <size_t stack_size>
+class null_interface : public interface::thread_safe<interface::no_opts>
+{
+public:
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(null_interface);
+
+protected:
+    size_t management_thread_stack_size() const override
+    {
+        return stack_size;
+    }
+    void process_close() override
+    {
+        transactions.p_close_op->end_op();
+    }
+    void process_open() override
+    {
+        transactions.p_open_op->end_op();
+    }
+    void process_send_receive() override
+    {
+        if (transactions.p_send_op != nullptr)
+            transactions.p_send_op->end_op();
+        if (transactions.p_recv_op != nullptr)
+            transactions.p_recv_op->end_op();
+    }
+    void wake_process() override
+    {
+    }
+};
+
+// reads a "<field>: <value> kB" line from /proc/self/status
+static long read_status_kb(const char *field)
+{
+    FILE *status_file = fopen("/proc/self/status", "r");
+    if (status_file == nullptr)
+        return -1;
+    char line[256];
+    long value         = -1;
+    const size_t f_len = strlen(field);
+    while (fgets(line, sizeof(line), status_file) != nullptr)
+        if (strncmp(line, field, f_len) == 0 && line[f_len] == ':')
+        {
+            value = strtol(line + f_len + 1, nullptr, 10);
+            break;
+        }
+    fclose(status_file);
+    return value;
+}
+
+template <size_t stack_size>
+static void run_footprint_case(size_t num_interfaces)
+{
+    const long rss_before = read_status_kb("VmRSS");
+    const long vm_before  = read_status_kb("VmSize");
+    {
+        std::list<null_interface<stack_size>> interfaces;
+        for (size_t i = 0; i < num_interfaces; i++)
+            if (interfaces.emplace_back().open() != interface::status_e::SUCCESS)
+            {
+                thread_printf("failed to open a null interface\n");
+                exit(EXIT_FAILURE);
+            }
+
+        const long rss_delta = read_status_kb("VmRSS") - rss_before;
+        const long vm_delta  = read_status_kb("VmSize") - vm_before;
+        thread_printf("| stack=%8zu | interfaces=%5zu | RSS +%8li kB (%6.1f kB each) | virtual +%9li kB (%8.1f kB each) |\n",
+                      stack_size, num_interfaces, rss_delta, static_cast<double>(rss_delta) / static_cast<double>(num_interfaces),
+                      vm_delta, static_cast<double>(vm_delta) / static_cast<double>(num_interfaces));
+    }
+}
+
+static void print_footprint(const char *label, const interface::footprint_report &report)
+{
+    thread_printf("| %-28s | object_size=%5zu | threads=%zu | thread_stack_size=%8zu | fds=%zu |\n",
+                  label, report.object_size, report.threads, report.thread_stack_size, report.fds);
+}
+
+int main()
+{
+    thread_printf("Footprint benchmark\n");
+    print_footprint("static udp::socket", interface::static_footprint<udp::socket>());
+    print_footprint("static udp::socket_raw", interface::static_footprint<udp::socket_raw>());
+    {
+        udp::socket server(udp::socket::opts()
+                               .role(udp::role_e::SERVER)
+                               .port(1240)
+                               .ipv4_address("127.0.0.1"));
+        print_footprint("runtime open udp::socket", interface::footprint_of(server));
+    }
+
+    for (size_t num_interfaces : {100u, 500u})
+    {
+        run_footprint_case<0u>(num_interfaces);
+        run_footprint_case<64u * 1024u>(num_interfaces);
+    }
+}
@@ -0,0 +1,323 @@
+#include "../examples/utils/printing.h"
+#include "../include/cpptxrx_crc32c.h"
+#include "../include/cpptxrx_fec.h"
+#include "../include/cpptxrx_jitter_buffer.h"
+#include "../include/cpptxrx_raw.h"
+#include "../include/cpptxrx_sequencing.h"
+#include "../include/default_udp.h"
+#include <new>
+#include <stdlib.h>
+#include <vector>
+
+#define fail_and_exit(...)                \
+    do                                    \
+    {                                     \
+        debug_printf(__VA_ARGS__);        \
+        thread_printf("Failed test!!\n"); \
+        exit(EXIT_FAILURE);               \
+    } while (0)
+
+// Every heap allocation made by any thread (including the management threads) is counted while "counting" is set, by
+// interposing operator new, and on glibc, malloc itself (so an operator new that calls malloc is counted twice, which
+// doesn't matter, since any allocation at all fails the test)
+static std::atomic<bool> counting{false};
+static std::atomic<size_t> allocations{0u};
+
+static void count_allocation() noexcept
+{
+    if (counting.load(std::memory_order_relaxed))
+        allocations.fetch_add(1u, std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *p, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+
+    void *malloc(size_t size) noexcept
+    {
+        count_allocation();
+        return __libc_malloc(size);
+    }
+    void *calloc(size_t count, size_t size) noexcept
+    {
+        count_allocation();
+        return __libc_calloc(count, size);
+    }
+    void *realloc(void *p, size_t size) noexcept
+    {
+        count_allocation();
+        return __libc_realloc(p, size);
+    }
+    void *aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        count_allocation();
+        return __libc_memalign(alignment, size);
+    }
+}
+#endif
+
+void *operator new(size_t size)
+{
+    count_allocation();
+    if (void *p = malloc(size > 0u ? size : 1u))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    count_allocation();
+    return malloc(size > 0u ? size : 1u);
+}
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+static constexpr size_t warm_up_ops  = 200u;
+static constexpr size_t measured_ops = 2000u;
+
+// runs "op" enough times to reach a steady state, and then fails if running it again allocates at all
+template <typename op_type>
+static void expect_no_allocations(const char *name, op_type &&op)
+{
+    for (size_t i = 0; i < warm_up_ops; i++)
+        op(i);
+    allocations.store(0u, std::memory_order_relaxed);
+    counting.store(true, std::memory_order_seq_cst);
+    for (size_t i = 0; i < measured_ops; i++)
+        op(i);
+    counting.store(false, std::memory_order_seq_cst);
+    const size_t counted = allocations.load(std::memory_order_relaxed);
+    if (counted != 0u)
+        fail_and_exit("%s: %zu allocations in %zu steady state operations\n", name, counted, measured_ops);
+    thread_printf("  %-28s 0 allocations in %zu operations\n", name, measured_ops);
+}
+
+static udp::opts loopback(uint16_t port, udp::role_e role)
+{
+    return udp::opts().role(role).port(port).ipv4_address("127.0.0.1");
+}
+
+template <typename sender_type, typename receiver_type>
+static void expect_no_allocations_sending_to(const char *name, sender_type &sender, receiver_type &receiver)
+{
+    if (!sender.is_open() || !receiver.is_open())
+        fail_and_exit("%s open error: %s, %s\n", name, sender.open_status().c_str(), receiver.open_status().c_str());
+    expect_no_allocations(name, [&](size_t i)
+                          {
+                              uint8_t tx_data[64];
+                              uint8_t rx_data[64 + 16]; // with room for any decorator trailers
+                              memset(tx_data, static_cast<int>(i), sizeof(tx_data));
+                              if (sender.send(tx_data, 1u + i % sizeof(tx_data), std::chrono::seconds(1)) != interface::status_e::SUCCESS)
+                                  fail_and_exit("%s send %zu error\n", name, i);
+                              auto result = receiver.receive(rx_data, std::chrono::seconds(1));
+                              if (result.status != interface::status_e::SUCCESS || result.size != 1u + i % sizeof(tx_data))
+                                  fail_and_exit("%s receive %zu error: %s\n", name, i, result.status.c_str());
+                          });
+}
+
+static void test_shipped_interfaces()
+{
+    {
+        udp::socket server(loopback(1250, udp::role_e::SERVER));
+        udp::socket client(loopback(1250, udp::role_e::CLIENT));
+        expect_no_allocations_sending_to("udp::socket", client, server);
+    }
+    {
+        udp::listener listener(loopback(1251, udp::role_e::SERVER));
+        udp::sender sender(loopback(1251, udp::role_e::CLIENT));
+        expect_no_allocations_sending_to("udp::sender/udp::listener", sender, listener);
+    }
+    {
+        udp::socket_raw server(loopback(1252, udp::role_e::SERVER));
+        udp::socket_raw client(loopback(1252, udp::role_e::CLIENT));
+        expect_no_allocations_sending_to("udp::socket_raw", client, server);
+    }
+    {
+        udp::socket server(loopback(1253, udp::role_e::SERVER).coalesce(1400u, std::chrono::microseconds(100)));
+        udp::socket client(loopback(1253, udp::role_e::CLIENT).coalesce(1400u, std::chrono::microseconds(100)));
+        expect_no_allocations_sending_to("udp::socket (coalescing)", client, server);
+    }
+}
+
+// defines a udp socket that queues its sends in the given send order (a macro rather than a template, since the
+// IMPORT_CPPTXRX_CTOR_AND_DTOR macro needs a non-dependent base)
+#define DEFINE_ORDERED_SOCKET(class_name, send_order_type)                                                                    \
+    class class_name : public interface::factory<udp::opts, interface::policy::policies<>::with_send_queue_depth<8>::with_send_order<send_order_type>> \
+    {                                                                                                                         \
+    public:                                                                                                                   \
+        IMPORT_CPPTXRX_CTOR_AND_DTOR(class_name);                                                                             \
+                                                                                                                              \
+    protected:                                                                                                                \
+        friend struct udp::socket_utilities;                                                                                  \
+        udp::socket_utilities utils = {};                                                                                     \
+                                                                                                                              \
+        void construct() override { utils.construct<true>(); }                                                                \
+        void destruct() override { utils.destruct<true>(); }                                                                 \
+        void process_close() override { utils.process_close(*this); }                                                        \
+        void process_open() override { utils.process_open(*this); }                                                          \
+        void process_send_receive() override { utils.process_send_receive<true>(*this); }                                     \
+        void wake_process() override { utils.wake_process(); }                                                                \
+    }
+DEFINE_ORDERED_SOCKET(deadline_ordered_socket, interface::policy::deadline_send_order<>);
+DEFINE_ORDERED_SOCKET(priority_ordered_socket, interface::policy::priority_send_order<2>);
+
+static void test_send_orders()
+{
+    {
+        udp::socket server(loopback(1260, udp::role_e::SERVER));
+        deadline_ordered_socket client(loopback(1260, udp::role_e::CLIENT));
+        expect_no_allocations_sending_to("deadline_send_order", client, server);
+    }
+    {
+        udp::socket server(loopback(1261, udp::role_e::SERVER));
+        priority_ordered_socket client(loopback(1261, udp::role_e::CLIENT));
+        expect_no_allocations_sending_to("priority_send_order", client, server);
+
+        // and through both lanes
+        uint8_t tx_data[64] = {};
+        expect_no_allocations("priority_send_order (lanes)", [&](size_t i)
+                              {
+                                  const auto priority = i % 2u == 0u ? interface::priority_e::HIGH : interface::priority_e::NORMAL;
+                                  if (client.send(tx_data, sizeof(tx_data), std::chrono::seconds(1), priority) != interface::status_e::SUCCESS)
+                                      fail_and_exit("priority lane send %zu error\n", i);
+                                  uint8_t rx_data[64];
+                                  if (server.receive(rx_data, std::chrono::seconds(1)).status != interface::status_e::SUCCESS)
+                                      fail_and_exit("priority lane receive %zu error\n", i);
+                              });
+    }
+}
+
+static void test_decorators()
+{
+    {
+        udp::socket server(loopback(1262, udp::role_e::SERVER));
+        udp::socket client(loopback(1262, udp::role_e::CLIENT));
+        interface::crc32c_integrity<> checked_server(server);
+        interface::crc32c_integrity<> checked_client(client);
+        expect_no_allocations_sending_to("crc32c_integrity", checked_client, checked_server);
+    }
+    {
+        udp::socket server(loopback(1263, udp::role_e::SERVER));
+        udp::socket client(loopback(1263, udp::role_e::CLIENT));
+        interface::sequencing<> sequenced_server(server);
+        interface::sequencing<> sequenced_client(client);
+        expect_no_allocations_sending_to("sequencing", sequenced_client, sequenced_server);
+    }
+    {
+        udp::socket server(loopback(1264, udp::role_e::SERVER));
+        udp::socket client(loopback(1264, udp::role_e::CLIENT));
+        interface::sequencing<> sequenced_server(server);
+        interface::sequencing<> sequenced_client(client);
+        interface::jitter_buffer<32> reordered_server(sequenced_server, std::chrono::milliseconds(10));
+        expect_no_allocations_sending_to("jitter_buffer", sequenced_client, reordered_server);
+    }
+    {
+        // the parity sent after each group is dropped by the receiving side, so sends and receives stay one to one
+        udp::socket server(loopback(1265, udp::role_e::SERVER));
+        udp::socket client(loopback(1265, udp::role_e::CLIENT));
+        interface::xor_fec<4, 1> protected_server(server);
+        interface::xor_fec<4, 1> protected_client(client);
+        expect_no_allocations_sending_to("xor_fec", protected_client, protected_server);
+    }
+}
+
+static void test_other_receive_paths()
+{
+    udp::socket server(loopback(1254, udp::role_e::SERVER));
+    udp::socket client(loopback(1254, udp::role_e::CLIENT));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("receive path open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+
+    uint8_t tx_data[64] = {};
+    expect_no_allocations("try_send/try_receive", [&](size_t i)
+                          {
+                              // both fall back to the management thread while it's busy, which can report WOULD_BLOCK
+                              interface::status_e status = interface::status_e::WOULD_BLOCK;
+                              while (status == interface::status_e::WOULD_BLOCK)
+                                  status = client.try_send(tx_data, sizeof(tx_data));
+                              if (status != interface::status_e::SUCCESS)
+                                  fail_and_exit("try_send %zu error: %s\n", i, status.c_str());
+                              uint8_t rx_data[64];
+                              interface::recv_ret result{interface::status_e::WOULD_BLOCK, 0u};
+                              while (result.status == interface::status_e::WOULD_BLOCK)
+                                  result = server.try_receive(rx_data, sizeof(rx_data));
+                              if (result.status != interface::status_e::SUCCESS)
+                                  fail_and_exit("try_receive %zu error: %s\n", i, result.status.c_str());
+                          });
+
+    // the container only grows while warming up, to the largest message
+    std::vector<uint8_t> rx_vector;
+    expect_no_allocations("receive_into", [&](size_t i)
+                          {
+                              if (client.send(tx_data, 1u + i % sizeof(tx_data), std::chrono::seconds(1)) != interface::status_e::SUCCESS)
+                                  fail_and_exit("receive_into send %zu error\n", i);
+                              auto result = server.receive_into(rx_vector, std::chrono::seconds(1));
+                              if (result.status != interface::status_e::SUCCESS || rx_vector.size() != 1u + i % sizeof(tx_data))
+                                  fail_and_exit("receive_into %zu error: %s\n", i, result.status.c_str());
+                          });
+
+    interface::receive_ring<4, 64> ring;
+    if (server.register_receive_ring(ring) != interface::status_e::SUCCESS)
+        fail_and_exit("couldn't register the receive ring\n");
+    expect_no_allocations("receive ring", [&](size_t i)
+                          {
+                              if (client.send(tx_data, sizeof(tx_data), std::chrono::seconds(1)) != interface::status_e::SUCCESS)
+                                  fail_and_exit("receive ring send %zu error\n", i);
+                              if (ring.wait_front(std::chrono::seconds(1)) == nullptr)
+                                  fail_and_exit("receive ring %zu error\n", i);
+                              ring.pop();
+                          });
+    server.unregister_receive_ring();
+}
+
+// makes sure the interposed allocators are actually being called, so that a pass means something
+static void test_allocations_are_counted()
+{
+    static volatile size_t size = 16u;
+    allocations.store(0u, std::memory_order_relaxed);
+    counting.store(true, std::memory_order_seq_cst);
+    {
+        std::vector<uint8_t> allocated(size);
+        allocated[0] = 1u;
+    }
+    counting.store(false, std::memory_order_seq_cst);
+    if (allocations.load(std::memory_order_relaxed) == 0u)
+        fail_and_exit("the allocation counter didn't see a vector being allocated\n");
+}
+
+int main()
+{
+    thread_printf("Starting allocation tests.\n");
+    test_allocations_are_counted();
+    test_shipped_interfaces();
+    test_send_orders();
+    test_decorators();
+    test_other_receive_paths();
+    thread_printf("Passed allocation tests!\n");
+    return 0;
+}
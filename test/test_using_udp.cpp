@@ -1,5 +1,13 @@
 #include "../examples/utils/printing.h"
+#include "../include/cpptxrx_crc32c.h"
+#include "../include/cpptxrx_fec.h"
+#include "../include/cpptxrx_jitter_buffer.h"
+#include "../include/cpptxrx_raw.h"
+#include "../include/cpptxrx_sequencing.h"
 #include "../include/default_udp.h"
+#include <list>
+#include <sys/epoll.h>
+#include <vector>
 
 #define fail_and_exit(...)                \
     do                                    \
@@ -186,6 +194,1758 @@ static void test_send_receive_then_closure_case(test_case_e test_case, size_t lo
     }
 }
 
+static void test_status_reads_during_rx()
+{
+    udp::socket server(udp::socket::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(1231)
+                           .ipv6_address("::ffff:127.0.0.1"));
+    if (!server.is_open())
+        fail_and_exit("server open error: %s\n", server.open_status().c_str());
+
+    // park the management thread in a long receive, the status reads and writes below must not wait for it to finish
+    interface::raii_thread rx_thread(
+        [&]()
+        {
+            uint8_t rx_data[100] = {};
+            server.receive(rx_data, sizeof(rx_data), std::chrono::milliseconds(300));
+        });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto start_time = std::chrono::steady_clock::now();
+    udp::socket::opts open_args;
+    for (int i = 0; i < 1000; i++)
+    {
+        if (!server.is_open() || server.open_status() != interface::status_e::SUCCESS)
+            fail_and_exit("server unexpectedly not open: %s\n", server.open_status().c_str());
+        if (!server.get_open_args(open_args) || open_args.m_port != 1231)
+            fail_and_exit("server open args were not available\n");
+        server.set_open_args(open_args);
+    }
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+    if (elapsed_ms > 100)
+        fail_and_exit("status reads/writes were blocked by the pending receive for %i ms\n", static_cast<int>(elapsed_ms));
+}
+
+static void test_send_during_pending_rx()
+{
+    // a server's default destination is its own bound address, so it can loop messages back to itself
+    udp::socket server(udp::socket::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(1232)
+                           .ipv6_address("::ffff:127.0.0.1"));
+    if (!server.is_open())
+        fail_and_exit("server open error: %s\n", server.open_status().c_str());
+
+    for (int i = 0; i < 100; i++)
+    {
+        // the send must be served by the same process_send_receive call that's waiting on the receive
+        interface::raii_thread rx_thread(
+            [&]()
+            {
+                uint8_t rx_data[100] = {};
+                auto rx_result_info  = server.receive(rx_data, sizeof(rx_data), std::chrono::seconds(5));
+                if (rx_result_info.status != interface::status_e::SUCCESS || rx_result_info.size != 5)
+                    fail_and_exit("server receive error: \"%s\" (size=%zu bytes, status=%s)\n", rx_data, rx_result_info.size, rx_result_info.status.c_str());
+            });
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+        uint8_t tx_data[] = "ping";
+        auto send_status  = server.send(tx_data, sizeof(tx_data), std::chrono::seconds(5));
+        if (send_status != interface::status_e::SUCCESS)
+            fail_and_exit("server send error: %s\n", send_status.c_str());
+    }
+}
+
+// an in-memory interface that serves sends inside process_send_receive while a receive stays pending, counting the number of
+// times the factory calls it, and the number of times its wait is woken up
+class wakeup_counter : public interface::factory<interface::no_opts, interface::policy::policies<>>
+{
+    using base_type = interface::factory<interface::no_opts, interface::policy::policies<>>;
+
+public:
+    using base_type::construct;
+    using base_type::destroy;
+    using base_type::open;
+    using base_type::threadsafe;
+    using typename base_type::opts;
+
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(wakeup_counter);
+
+    std::atomic<size_t> calls{0u};
+    std::atomic<size_t> wakeups{0u};
+    std::atomic<size_t> sends_served{0u};
+
+protected:
+    using base_type::transactions;
+
+    std::mutex wake_mutex{};
+    std::condition_variable wake_cv{};
+    size_t wake_requests = 0u;
+
+    void process_close() override
+    {
+        transactions.p_close_op->end_op();
+    }
+    void process_open() override
+    {
+        transactions.p_open_op->end_op();
+    }
+    void process_send_receive() override
+    {
+        calls.fetch_add(1u, std::memory_order_relaxed);
+        while (true)
+        {
+            if (transactions.p_send_op != nullptr)
+            {
+                transactions.p_send_op->end_op();
+                sends_served.fetch_add(1u, std::memory_order_relaxed);
+            }
+
+            // hands back the finished send and accepts any new one in the same call, which is served without waiting
+            if (!sync_send_receive())
+                return;
+            if (transactions.p_send_op != nullptr)
+                continue;
+
+            std::unique_lock<std::mutex> lk(wake_mutex);
+            const auto end_time = transactions.p_recv_op != nullptr ? transactions.p_recv_op->end_time
+                                                                    : std::chrono::steady_clock::time_point::max();
+            if (wake_cv.wait_until(lk, end_time, [this]()
+                                   { return wake_requests > 0u; }))
+            {
+                wake_requests = 0u;
+                wakeups.fetch_add(1u, std::memory_order_relaxed);
+            }
+        }
+    }
+    void wake_process() override
+    {
+        {
+            std::lock_guard<std::mutex> lk(wake_mutex);
+            wake_requests++;
+        }
+        wake_cv.notify_one();
+    }
+};
+
+static void test_wakeups_during_pending_rx()
+{
+    wakeup_counter counter;
+    if (counter.open() != interface::status_e::SUCCESS)
+        fail_and_exit("wakeup counter open error\n");
+
+    interface::raii_thread rx_thread(
+        [&]()
+        {
+            uint8_t rx_data[10];
+            auto result = counter.receive(rx_data, sizeof(rx_data), std::chrono::milliseconds(500));
+            if (result.status != interface::status_e::TIMED_OUT)
+                fail_and_exit("expected the wakeup counter's receive to time out, not: %s\n", result.status.c_str());
+        });
+    while (counter.calls.load(std::memory_order_relaxed) == 0u)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // every send is picked up, served, and handed back while the one process_send_receive call keeps waiting on the receive,
+    // with at most one wakeup per send, since a send requested while the last one is being handed back is picked up by the
+    // same sync_send_receive call, without waking at all
+    constexpr size_t num_sends = 20u;
+    const size_t wakeups_before = counter.wakeups.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < num_sends; i++)
+    {
+        uint8_t tx_data = static_cast<uint8_t>(i);
+        if (counter.send(&tx_data, 1u, std::chrono::milliseconds(100)) != interface::status_e::SUCCESS)
+            fail_and_exit("wakeup counter send %zu error\n", i);
+    }
+    const size_t calls   = counter.calls.load(std::memory_order_relaxed);
+    const size_t wakeups = counter.wakeups.load(std::memory_order_relaxed) - wakeups_before;
+    if (calls != 1u || wakeups > num_sends || counter.sends_served.load(std::memory_order_relaxed) != num_sends)
+        fail_and_exit("expected 1 process_send_receive call and at most %zu wakeups for %zu sends, but got %zu calls and %zu wakeups\n",
+                      num_sends, num_sends, calls, wakeups);
+}
+
+static int count_process_threads()
+{
+    FILE *status_file = fopen("/proc/self/status", "r");
+    if (status_file == nullptr)
+        fail_and_exit("unable to open /proc/self/status\n");
+    char line[256];
+    int threads = -1;
+    while (fgets(line, sizeof(line), status_file) != nullptr)
+        if (sscanf(line, "Threads: %i", &threads) == 1)
+            break;
+    fclose(status_file);
+    return threads;
+}
+
+class retiring_socket : public udp::socket
+{
+public:
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(retiring_socket);
+
+protected:
+    std::chrono::nanoseconds idle_thread_timeout() const override
+    {
+        return std::chrono::milliseconds(10);
+    }
+};
+
+// a socket whose idle timeout is just short of the "never retire" value, which must not overflow when waited on
+class long_idle_socket : public udp::socket
+{
+public:
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(long_idle_socket);
+
+protected:
+    std::chrono::nanoseconds idle_thread_timeout() const override
+    {
+        return std::chrono::nanoseconds::max() - std::chrono::nanoseconds(1);
+    }
+};
+
+static void test_lazy_and_retiring_threads()
+{
+    const int threads_before = count_process_threads();
+    {
+        // management threads should only be started once an operation is requested
+        udp::socket unused_sockets[20];
+        if (count_process_threads() != threads_before)
+            fail_and_exit("unused sockets started %i threads\n", count_process_threads() - threads_before);
+
+        retiring_socket server(udp::socket::opts()
+                                   .role(udp::role_e::SERVER)
+                                   .port(1233)
+                                   .ipv6_address("::ffff:127.0.0.1"));
+        if (!server.is_open() || count_process_threads() != threads_before + 1)
+            fail_and_exit("server didn't start its thread: %s\n", server.open_status().c_str());
+        auto report = interface::footprint_of(server);
+        if (report.threads != 1u || report.fds != 3u || report.object_size != sizeof(retiring_socket))
+            fail_and_exit("unexpected footprint: threads=%zu fds=%zu size=%zu\n", report.threads, report.fds, report.object_size);
+
+        // an open interface must keep its thread, even when idle
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (count_process_threads() != threads_before + 1)
+            fail_and_exit("open server retired its thread\n");
+
+        // but a closed one can retire it, and restart it on demand
+        if (server.close() != interface::status_e::SUCCESS)
+            fail_and_exit("server close error\n");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (count_process_threads() != threads_before || server.footprint().threads != 0u || server.footprint().fds != 2u)
+            fail_and_exit("closed server didn't retire its thread\n");
+        auto reopen_status = server.reopen();
+        if (reopen_status != interface::status_e::SUCCESS || count_process_threads() != threads_before + 1)
+            fail_and_exit("server reopen error: %s\n", reopen_status.c_str());
+
+        // and the restarted thread serves sends and receives (where a server sends to its own address by default)
+        uint8_t tx_data[] = "ping";
+        uint8_t rx_data[sizeof(tx_data)];
+        if (server.send(tx_data, sizeof(tx_data)) != interface::status_e::SUCCESS)
+            fail_and_exit("send error after the thread restarted\n");
+        auto result = server.receive(rx_data, std::chrono::seconds(1));
+        if (result.status != interface::status_e::SUCCESS || result.size != sizeof(tx_data) || memcmp(rx_data, tx_data, sizeof(tx_data)) != 0)
+            fail_and_exit("receive error after the thread restarted: %s\n", result.status.c_str());
+        if (server.close() != interface::status_e::SUCCESS)
+            fail_and_exit("server close error\n");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    {
+        // a closed interface with a very long idle timeout keeps its thread, instead of overflowing the deadline
+        long_idle_socket server(udp::socket::opts()
+                                    .role(udp::role_e::SERVER)
+                                    .port(1233)
+                                    .ipv6_address("::ffff:127.0.0.1"));
+        if (server.close() != interface::status_e::SUCCESS)
+            fail_and_exit("long idle server close error\n");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (count_process_threads() != threads_before + 1)
+            fail_and_exit("long idle server retired its thread early\n");
+    }
+    if (count_process_threads() != threads_before)
+        fail_and_exit("threads leaked after destruction\n");
+}
+
+// a udp socket built from a custom set of policies, that lets several sends queue up behind the one being sent
+using queued_policies = interface::policy::policies<>::with_send_queue_depth<8>::with_wait<interface::policy::spin_then_block_wait<32>>::with_clock<interface::policy::coarse_steady_clock>;
+class queued_socket : public interface::factory<udp::opts, queued_policies>
+{
+public:
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(queued_socket);
+
+protected:
+    friend struct udp::socket_utilities;
+    udp::socket_utilities utils = {};
+
+    void construct() override
+    {
+        utils.construct<true>();
+    }
+    void destruct() override
+    {
+        utils.destruct<true>();
+    }
+    void process_close() override
+    {
+        utils.process_close(*this);
+    }
+    void process_open() override
+    {
+        utils.process_open(*this);
+    }
+    void process_send_receive() override
+    {
+        utils.process_send_receive<true>(*this);
+    }
+    void wake_process() override
+    {
+        utils.wake_process();
+    }
+};
+static_assert(queued_socket::threadsafe && !interface::raw<interface::no_opts>::threadsafe);
+
+static void test_custom_policies()
+{
+    constexpr size_t num_senders = 4;
+    constexpr size_t num_sends   = 50;
+
+    // a server's default destination is its own bound address, so it can loop messages back to itself
+    queued_socket server(udp::opts()
+                             .role(udp::role_e::SERVER)
+                             .port(1235)
+                             .ipv6_address("::ffff:127.0.0.1"));
+    if (!server.is_open())
+        fail_and_exit("server open error: %s\n", server.open_status().c_str());
+
+    std::atomic<size_t> received{0};
+    interface::raii_thread rx_thread(
+        [&]()
+        {
+            uint8_t rx_data[100] = {};
+            while (received < num_senders * num_sends)
+            {
+                auto rx_result_info = server.receive(rx_data, sizeof(rx_data), std::chrono::seconds(2));
+                if (rx_result_info.status != interface::status_e::SUCCESS)
+                    fail_and_exit("server receive error after %zu receives: %s\n", received.load(), rx_result_info.status.c_str());
+                received++;
+            }
+        });
+    {
+        std::list<interface::raii_thread> tx_threads;
+        for (size_t i = 0; i < num_senders; i++)
+            tx_threads.emplace_back(
+                [&]()
+                {
+                    uint8_t tx_data[] = "ping";
+                    for (size_t j = 0; j < num_sends; j++)
+                    {
+                        auto send_status = server.send(tx_data, sizeof(tx_data), std::chrono::seconds(2));
+                        if (send_status != interface::status_e::SUCCESS)
+                            fail_and_exit("server send error: %s\n", send_status.c_str());
+                    }
+                });
+    }
+}
+
+// a udp socket that's only ever used by one sending thread and one receiving thread at a time
+class spsc_socket : public interface::thread_safe_spsc<udp::opts>
+{
+public:
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(spsc_socket);
+
+protected:
+    friend struct udp::socket_utilities;
+    udp::socket_utilities utils = {};
+
+    void construct() override
+    {
+        utils.construct<true>();
+    }
+    void destruct() override
+    {
+        utils.destruct<true>();
+    }
+    void process_close() override
+    {
+        utils.process_close(*this);
+    }
+    void process_open() override
+    {
+        utils.process_open(*this);
+    }
+    void process_send_receive() override
+    {
+        utils.process_send_receive<true>(*this);
+    }
+    void wake_process() override
+    {
+        utils.wake_process();
+    }
+};
+
+static void test_single_caller_policy()
+{
+    constexpr size_t num_sends = 500;
+    {
+        spsc_socket server(udp::opts()
+                               .role(udp::role_e::SERVER)
+                               .port(1236)
+                               .ipv6_address("::ffff:127.0.0.1"));
+        if (!server.is_open())
+            fail_and_exit("server open error: %s\n", server.open_status().c_str());
+
+        // with nothing to receive, a receive should time out, and be withdrawn cleanly
+        uint8_t rx_data[100] = {};
+        auto rx_result_info  = server.receive(rx_data, sizeof(rx_data), std::chrono::milliseconds(10));
+        if (rx_result_info.status != interface::status_e::TIMED_OUT)
+            fail_and_exit("expected a receive time out, got: %s\n", rx_result_info.status.c_str());
+
+        // one dedicated receiving thread, and one dedicated sending thread
+        interface::raii_thread rx_thread(
+            [&]()
+            {
+                uint8_t thread_rx_data[100] = {};
+                for (size_t i = 0; i < num_sends; i++)
+                {
+                    auto thread_rx_result_info = server.receive(thread_rx_data, sizeof(thread_rx_data), std::chrono::seconds(2));
+                    if (thread_rx_result_info.status != interface::status_e::SUCCESS || thread_rx_result_info.size != 5)
+                        fail_and_exit("server receive %zu error: %s\n", i, thread_rx_result_info.status.c_str());
+                }
+            });
+        uint8_t tx_data[] = "ping";
+        for (size_t i = 0; i < num_sends; i++)
+        {
+            auto send_status = server.send(tx_data, sizeof(tx_data), std::chrono::seconds(2));
+            if (send_status != interface::status_e::SUCCESS)
+                fail_and_exit("server send error: %s\n", send_status.c_str());
+
+            // keep the receiver from falling too far behind, so the socket's receive buffer can't overflow
+            if (i % 50 == 49)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    {
+        // a destroy must cancel a pending receive
+        spsc_socket server(udp::opts()
+                               .role(udp::role_e::SERVER)
+                               .port(1236)
+                               .ipv6_address("::ffff:127.0.0.1"));
+        interface::raii_thread rx_thread(
+            [&]()
+            {
+                uint8_t thread_rx_data[100] = {};
+                auto thread_rx_result_info  = server.receive(thread_rx_data, sizeof(thread_rx_data), std::chrono::seconds(5));
+                if (thread_rx_result_info.status != interface::status_e::CANCELED_IN_DESTROY)
+                    fail_and_exit("expected a canceled receive, got: %s\n", thread_rx_result_info.status.c_str());
+            });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto start_time = std::chrono::steady_clock::now();
+        server.destroy();
+        if (std::chrono::steady_clock::now() - start_time > std::chrono::seconds(1))
+            fail_and_exit("destroy waited on the pending receive\n");
+    }
+}
+
+static_assert(udp::sender::can_send && !udp::sender::can_receive && !udp::listener::can_send && udp::listener::can_receive);
+
+static void test_unidirectional_sockets()
+{
+    constexpr size_t num_sends = 100;
+
+    udp::listener listener(udp::opts()
+                               .role(udp::role_e::SERVER)
+                               .port(1237)
+                               .ipv4_address("127.0.0.1"));
+    udp::sender sender(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1237)
+                           .ipv4_address("127.0.0.1"));
+    if (!listener.is_open() || !sender.is_open())
+        fail_and_exit("open error: %s, %s\n", listener.open_status().c_str(), sender.open_status().c_str());
+
+    // the compiled out direction should fail right away, without touching the management thread
+    uint8_t rx_data[100] = {};
+    uint8_t tx_data[]    = "ping";
+    auto rx_result_info  = sender.receive(rx_data, sizeof(rx_data), std::chrono::seconds(5));
+    if (rx_result_info.status != interface::status_e::UNSUPPORTED_OP || listener.send(tx_data, sizeof(tx_data)) != interface::status_e::UNSUPPORTED_OP)
+        fail_and_exit("expected unsupported operations, got: %s\n", rx_result_info.status.c_str());
+
+    interface::raii_thread rx_thread(
+        [&]()
+        {
+            uint8_t thread_rx_data[100] = {};
+            for (size_t i = 0; i < num_sends; i++)
+            {
+                auto thread_rx_result_info = listener.receive(thread_rx_data, sizeof(thread_rx_data), std::chrono::seconds(2));
+                if (thread_rx_result_info.status != interface::status_e::SUCCESS || thread_rx_result_info.size != sizeof(tx_data))
+                    fail_and_exit("listener receive %zu error: %s\n", i, thread_rx_result_info.status.c_str());
+            }
+        });
+    for (size_t i = 0; i < num_sends; i++)
+    {
+        auto send_status = sender.send(tx_data, sizeof(tx_data), std::chrono::seconds(2));
+        if (send_status != interface::status_e::SUCCESS)
+            fail_and_exit("sender send error: %s\n", send_status.c_str());
+
+        // keep the listener from falling too far behind, so the socket's receive buffer can't overflow
+        if (i % 50 == 49)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// a udp socket with its hooks resolved statically, rather than through virtual methods
+class static_socket : public interface::thread_safe_static<static_socket, udp::opts>
+{
+public:
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(static_socket);
+
+    [[nodiscard]] const char *name() const { return "static_socket"; }
+
+protected:
+    friend struct udp::socket_utilities;
+    udp::socket_utilities utils = {};
+
+    void construct()
+    {
+        utils.construct<true>();
+    }
+    void destruct()
+    {
+        utils.destruct<true>();
+    }
+    void process_close()
+    {
+        utils.process_close(*this);
+    }
+    void process_open()
+    {
+        utils.process_open(*this);
+    }
+    void process_send_receive()
+    {
+        utils.process_send_receive<true>(*this);
+    }
+    void wake_process()
+    {
+        utils.wake_process();
+    }
+};
+static_assert(!std::is_base_of<interface::abstract, static_socket>::value && std::is_base_of<interface::abstract, interface::polymorphic<static_socket>>::value);
+
+static void test_static_dispatch()
+{
+    static_socket server(udp::opts()
+                             .role(udp::role_e::SERVER)
+                             .port(1238)
+                             .ipv4_address("127.0.0.1"));
+    if (!server)
+        fail_and_exit("static server open error: %s\n", server.open_status().c_str());
+    uint8_t tx_data[]    = "ping";
+    uint8_t rx_data[100] = {};
+    if (server.send(tx_data) != interface::status_e::SUCCESS || server.receive(rx_data, std::chrono::seconds(2)).size != sizeof(tx_data))
+        fail_and_exit("static server send/receive error\n");
+    if (server.close() != interface::status_e::SUCCESS || server.receive(rx_data).status != interface::status_e::NOT_OPEN)
+        fail_and_exit("static server close error\n");
+
+    // and wrapped in the opt-in adapter, so that it can be used polymorphically
+    interface::polymorphic<static_socket> wrapped(udp::opts()
+                                                      .role(udp::role_e::SERVER)
+                                                      .port(1238)
+                                                      .ipv4_address("127.0.0.1"));
+    interface::abstract &conn = wrapped;
+    if (!conn.is_open() || strcmp(conn.name(), "static_socket") != 0)
+        fail_and_exit("wrapped static server open error: %s\n", conn.open_status().c_str());
+    if (conn.send(tx_data) != interface::status_e::SUCCESS || conn.receive(rx_data, std::chrono::seconds(2)).size != sizeof(tx_data))
+        fail_and_exit("wrapped static server send/receive error\n");
+}
+
+static void test_event_loop_driven_raw_sockets()
+{
+    constexpr size_t num_sends = 100;
+
+    udp::socket_raw server(udp::opts()
+                               .role(udp::role_e::SERVER)
+                               .port(1239)
+                               .ipv4_address("127.0.0.1"));
+    udp::socket_raw client(udp::opts()
+                               .role(udp::role_e::CLIENT)
+                               .port(1239)
+                               .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("raw open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+
+    // drive both sockets from a single epoll loop, with nothing ever blocking inside the sockets
+    int epoll_fd = epoll_create1(0);
+    if (epoll_fd < 0)
+        fail_and_exit("epoll_create1 failed\n");
+    auto watch = [&](udp::socket_raw &conn)
+    {
+        auto ready = conn.readiness();
+        epoll_event event{};
+        event.events   = (ready.readable ? EPOLLIN : 0u) | (ready.writable ? EPOLLOUT : 0u);
+        event.data.ptr = &conn;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, ready.fd, &event) != 0 && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ready.fd, &event) != 0)
+            fail_and_exit("epoll_ctl failed\n");
+    };
+
+    uint8_t tx_data[]    = "ping";
+    uint8_t rx_data[100] = {};
+    for (size_t i = 0; i < num_sends; i++)
+    {
+        const auto end_time = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        interface::recv_op rx_op{end_time, interface::status_e::IN_PROGRESS, rx_data, sizeof(rx_data), 0u};
+        interface::send_op tx_op{end_time, interface::status_e::IN_PROGRESS, tx_data, sizeof(tx_data)};
+        if (server.post_receive(rx_op) != interface::status_e::SUCCESS || client.post_send(tx_op) != interface::status_e::SUCCESS)
+            fail_and_exit("post error\n");
+        if (server.post_receive(rx_op) != interface::status_e::WOULD_BLOCK || server.receive(rx_data).status != interface::status_e::WOULD_BLOCK)
+            fail_and_exit("expected a second receive to be refused while one is posted\n");
+        watch(server);
+        watch(client);
+
+        while (rx_op.status == interface::status_e::IN_PROGRESS || tx_op.status == interface::status_e::IN_PROGRESS)
+        {
+            epoll_event events[2];
+            const int num_events = epoll_wait(epoll_fd, events, 2, 2000);
+            if (num_events <= 0)
+                fail_and_exit("epoll_wait timed out on send %zu\n", i);
+            for (int j = 0; j < num_events; j++)
+            {
+                auto &conn = *static_cast<udp::socket_raw *>(events[j].data.ptr);
+                conn.poll_once();
+                watch(conn);
+            }
+        }
+        if (rx_op.status != interface::status_e::SUCCESS || rx_op.returned_recv_size != sizeof(tx_data) || tx_op.status != interface::status_e::SUCCESS)
+            fail_and_exit("event loop send/receive %zu error: %s, %s\n", i, rx_op.status.c_str(), tx_op.status.c_str());
+    }
+    close(epoll_fd);
+
+    // with nothing to receive, a posted receive should time out on the next poll after its deadline
+    interface::recv_op rx_op{std::chrono::steady_clock::now() + std::chrono::milliseconds(10), interface::status_e::IN_PROGRESS, rx_data, sizeof(rx_data), 0u};
+    if (server.post_receive(rx_op) != interface::status_e::SUCCESS || server.readiness().deadline != rx_op.end_time)
+        fail_and_exit("expected the posted receive's deadline\n");
+    std::this_thread::sleep_until(rx_op.end_time + std::chrono::milliseconds(1));
+    if (server.poll_once() != 1u || rx_op.status != interface::status_e::TIMED_OUT)
+        fail_and_exit("expected a posted receive time out, got: %s\n", rx_op.status.c_str());
+
+    // and a destroy should cancel a posted receive
+    interface::recv_op canceled_rx_op{std::chrono::steady_clock::now() + std::chrono::seconds(5), interface::status_e::IN_PROGRESS, rx_data, sizeof(rx_data), 0u};
+    if (server.post_receive(canceled_rx_op) != interface::status_e::SUCCESS || server.poll_once() != 0u)
+        fail_and_exit("post error\n");
+    server.destroy();
+    if (canceled_rx_op.status != interface::status_e::CANCELED_IN_DESTROY)
+        fail_and_exit("expected a canceled posted receive, got: %s\n", canceled_rx_op.status.c_str());
+}
+
+template <typename socket_type>
+static void test_try_send_receive_on(uint16_t port)
+{
+    socket_type server(udp::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(port)
+                           .ipv4_address("127.0.0.1"));
+    socket_type client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(port)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("try open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+
+    // called through "abstract", to make sure the factory's try_ methods override its defaults (which are UNSUPPORTED_OP)
+    interface::abstract &polymorphic_server = server;
+    interface::abstract &polymorphic_client = client;
+
+    uint8_t tx_data[]    = "ping";
+    uint8_t rx_data[100] = {};
+    auto result          = polymorphic_server.try_receive(rx_data, sizeof(rx_data));
+    if (result.status != interface::status_e::WOULD_BLOCK)
+        fail_and_exit("expected an empty try_receive to return WOULD_BLOCK, not %s\n", result.status.c_str());
+
+    // neither side ever waits, so retry until the datagram makes it through loopback
+    const auto end_time = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    interface::status_e tx_status = interface::status_e::WOULD_BLOCK;
+    while ((tx_status = polymorphic_client.try_send(tx_data, sizeof(tx_data))) == interface::status_e::WOULD_BLOCK && std::chrono::steady_clock::now() < end_time)
+        std::this_thread::yield();
+    if (tx_status != interface::status_e::SUCCESS)
+        fail_and_exit("try_send error: %s\n", tx_status.c_str());
+    do
+        result = polymorphic_server.try_receive(rx_data, sizeof(rx_data));
+    while (result.status == interface::status_e::WOULD_BLOCK && std::chrono::steady_clock::now() < end_time);
+    if (result.status != interface::status_e::SUCCESS || result.size != sizeof(tx_data) || memcmp(rx_data, tx_data, sizeof(tx_data)) != 0)
+        fail_and_exit("try_receive error: %s, size %zu\n", result.status.c_str(), result.size);
+
+    server.close();
+    if (server.try_receive(rx_data, sizeof(rx_data)).status != interface::status_e::NOT_OPEN)
+        fail_and_exit("expected try_receive on a closed socket to return NOT_OPEN\n");
+}
+
+// a udp socket that queues its sends earliest deadline first, which fails expired sends before they're sent
+class deadline_socket : public interface::factory<udp::opts, interface::policy::policies<>::with_send_queue_depth<8>::with_send_order<interface::policy::deadline_send_order<>>>
+{
+public:
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(deadline_socket);
+
+protected:
+    friend struct udp::socket_utilities;
+    udp::socket_utilities utils = {};
+
+    void construct() override
+    {
+        utils.construct<true>();
+    }
+    void destruct() override
+    {
+        utils.destruct<true>();
+    }
+    void process_close() override
+    {
+        utils.process_close(*this);
+    }
+    void process_open() override
+    {
+        utils.process_open(*this);
+    }
+    void process_send_receive() override
+    {
+        utils.process_send_receive<true>(*this);
+    }
+    void wake_process() override
+    {
+        utils.wake_process();
+    }
+};
+
+template <typename socket_type>
+static void test_try_send_during_pending_rx_on(uint16_t port)
+{
+    constexpr size_t num_sends = 1000;
+
+    udp::socket server(udp::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(port)
+                           .ipv4_address("127.0.0.1"));
+    socket_type client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(port)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("pending rx try open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+
+    // with a receive blocked on another thread, the management thread is busy, so each try_send is handed to it, which
+    // still has to attempt it once, rather than letting its timeout of zero expire it
+    interface::raii_thread rx_thread(
+        [&]()
+        {
+            uint8_t thread_rx_data[100] = {};
+            (void)client.receive(thread_rx_data, sizeof(thread_rx_data), std::chrono::seconds(5));
+        });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    uint8_t tx_data[] = "ping";
+    size_t sent       = 0u;
+    for (size_t i = 0; i < num_sends; i++)
+    {
+        auto status = client.try_send(tx_data, sizeof(tx_data));
+        if (status == interface::status_e::SUCCESS)
+            sent++;
+        else if (status != interface::status_e::WOULD_BLOCK)
+            fail_and_exit("try_send during a pending receive error: %s\n", status.c_str());
+
+        // keep the server's receive buffer from overflowing
+        uint8_t rx_data[100] = {};
+        while (server.try_receive(rx_data, sizeof(rx_data)).status == interface::status_e::SUCCESS)
+        {
+        }
+    }
+    if (sent < num_sends / 2u)
+        fail_and_exit("expected most try_sends during a pending receive to succeed, but only %zu of %zu did\n", sent, num_sends);
+    client.close(); // cancels the pending receive
+}
+
+static void test_try_send_receive()
+{
+    test_try_send_receive_on<udp::socket_raw>(1241);
+    test_try_send_receive_on<udp::socket>(1242);
+    test_try_send_during_pending_rx_on<udp::socket>(1267);
+    test_try_send_during_pending_rx_on<deadline_socket>(1268);
+
+    uint8_t data[10] = {};
+    udp::listener listener;
+    udp::sender sender;
+    if (listener.try_send(data, sizeof(data)) != interface::status_e::UNSUPPORTED_OP || sender.try_receive(data, sizeof(data)).status != interface::status_e::UNSUPPORTED_OP)
+        fail_and_exit("expected try_ operations in an unsupported direction to return UNSUPPORTED_OP\n");
+}
+
+static void test_short_timeout_sends()
+{
+    udp::socket server(udp::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(1266)
+                           .ipv4_address("127.0.0.1"));
+    udp::socket client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1266)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("short timeout open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+
+    // an idle socket can send right away, so a send whose timeout has already passed by the time it's processed still goes out
+    uint8_t tx_data[]    = "ping";
+    uint8_t rx_data[100] = {};
+    for (auto timeout : {std::chrono::nanoseconds(0), std::chrono::nanoseconds(1), std::chrono::nanoseconds(1000)})
+    {
+        for (size_t i = 0; i < 10; i++)
+        {
+            auto status = client.send(tx_data, sizeof(tx_data), timeout);
+            if (status != interface::status_e::SUCCESS)
+                fail_and_exit("expected a %lld ns send on an idle socket to succeed, not %s\n", static_cast<long long>(timeout.count()), status.c_str());
+            auto result = server.receive(rx_data, std::chrono::seconds(1));
+            if (result.status != interface::status_e::SUCCESS || result.size != sizeof(tx_data))
+                fail_and_exit("short timeout receive error: %s\n", result.status.c_str());
+        }
+    }
+}
+
+// a udp socket that does some periodic work (like a keepalive) every 10ms while it's open, using next_wakeup
+class ticking_socket : public udp::socket
+{
+public:
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(ticking_socket);
+
+    std::atomic<size_t> ticks{0u};
+
+protected:
+    std::chrono::steady_clock::time_point next_tick{};
+
+    void process_open() override
+    {
+        udp::socket::process_open();
+        if (transactions.p_open_op->status == interface::status_e::SUCCESS)
+            transactions.next_wakeup = next_tick = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+    }
+    void process_send_receive() override
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= next_tick)
+        {
+            ticks.fetch_add(1u, std::memory_order_relaxed);
+            transactions.next_wakeup = next_tick = now + std::chrono::milliseconds(10);
+        }
+        if (transactions.p_send_op != nullptr || transactions.p_recv_op != nullptr)
+            udp::socket::process_send_receive();
+    }
+};
+
+static void test_backend_wakeups()
+{
+    ticking_socket server(udp::opts()
+                              .role(udp::role_e::SERVER)
+                              .port(1243)
+                              .ipv4_address("127.0.0.1"));
+    udp::socket client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1243)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("ticking open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+
+    // the ticks should keep going both during a receive, and while idle
+    uint8_t tx_data[]    = "ping";
+    uint8_t rx_data[100] = {};
+    std::thread sending_thread([&]()
+                               {
+                                   std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                                   client.send(tx_data, sizeof(tx_data)); });
+    auto result = server.receive(rx_data, sizeof(rx_data), std::chrono::seconds(2));
+    sending_thread.join();
+    if (result.status != interface::status_e::SUCCESS || result.size != sizeof(tx_data))
+        fail_and_exit("ticking receive error: %s\n", result.status.c_str());
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    const size_t ticks = server.ticks.load(std::memory_order_relaxed);
+    if (ticks < 10u || ticks > 40u)
+        fail_and_exit("expected about 20 ticks over 200ms, but got %zu\n", ticks);
+}
+
+// an in-memory interface that records the order its sends reach the process_ methods in, where each send is held until released
+template <typename send_order_type>
+class send_order_recorder
+    : public interface::factory<interface::no_opts, interface::policy::policies<>::with_send_queue_depth<8>::with_send_order<send_order_type>>
+{
+    using base_type = interface::factory<interface::no_opts, interface::policy::policies<>::with_send_queue_depth<8>::with_send_order<send_order_type>>;
+
+public:
+    using base_type::construct;
+    using base_type::destroy;
+    using base_type::open;
+    using base_type::threadsafe;
+    using typename base_type::opts;
+
+    IMPORT_CPPTXRX_CTOR_AND_DTOR(send_order_recorder);
+
+    std::atomic<bool> holding{false};
+    std::atomic<bool> released{false};
+    std::string order{};
+
+protected:
+    using base_type::transactions;
+
+    void process_close() override
+    {
+        transactions.p_close_op->end_op();
+    }
+    void process_open() override
+    {
+        transactions.p_open_op->end_op();
+    }
+    void process_send_receive() override
+    {
+        if (transactions.p_send_op == nullptr)
+            return;
+        holding = true;
+        while (!released)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        order += static_cast<char>(transactions.p_send_op->send_data[0]);
+        transactions.p_send_op->end_op();
+    }
+    void wake_process() override
+    {
+    }
+};
+
+struct recorded_send
+{
+    uint8_t data;
+    std::chrono::milliseconds timeout;
+    interface::priority_e priority;
+    interface::status_e expected;
+};
+
+// sends each of "sends" from its own thread, where the first is held by the recorder until the rest are queued up behind it
+template <typename send_order_type, size_t num_sends>
+static std::string record_send_order(const recorded_send (&sends)[num_sends])
+{
+    send_order_recorder<send_order_type> recorder;
+    if (recorder.open() != interface::status_e::SUCCESS)
+        fail_and_exit("recorder open error\n");
+    {
+        std::list<interface::raii_thread> tx_threads;
+        for (const auto &send : sends)
+        {
+            tx_threads.emplace_back(
+                [&]()
+                {
+                    auto status = recorder.send(&send.data, 1u, send.timeout, send.priority);
+                    if (status != send.expected)
+                        fail_and_exit("send %c returned %s\n", send.data, status.c_str());
+                });
+
+            // let the first send become active, and each of the others join the queue behind it, before the next one
+            while (!recorder.holding)
+                std::this_thread::yield();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        recorder.released = true;
+    }
+    return recorder.order;
+}
+
+static void test_send_orders()
+{
+    constexpr auto normal = interface::priority_e::NORMAL;
+    constexpr auto high   = interface::priority_e::HIGH;
+    constexpr auto ok     = interface::status_e::SUCCESS;
+
+    // earliest deadline first, where expired sends are dropped without being sent
+    const recorded_send timed_sends[] = {{'0', std::chrono::milliseconds(5000), normal, ok},
+                                         {'1', std::chrono::milliseconds(4000), normal, ok},
+                                         {'2', std::chrono::milliseconds(1000), normal, ok},
+                                         {'3', std::chrono::milliseconds(3000), normal, ok},
+                                         {'4', std::chrono::milliseconds(50), normal, interface::status_e::TIMED_OUT},
+                                         {'5', std::chrono::milliseconds(2000), normal, ok}};
+    auto order = record_send_order<interface::policy::deadline_send_order<>>(timed_sends);
+    if (order != "02531")
+        fail_and_exit("expected the queued sends in deadline order \"02531\", but got \"%s\"\n", order.c_str());
+
+    // high priority first, but with every second high priority send followed by a waiting normal priority one
+    const recorded_send prioritized_sends[] = {{'0', std::chrono::milliseconds(2000), normal, ok},
+                                               {'a', std::chrono::milliseconds(2000), high, ok},
+                                               {'x', std::chrono::milliseconds(2000), normal, ok},
+                                               {'b', std::chrono::milliseconds(2000), high, ok},
+                                               {'c', std::chrono::milliseconds(2000), high, ok},
+                                               {'y', std::chrono::milliseconds(2000), normal, ok},
+                                               {'d', std::chrono::milliseconds(2000), high, ok}};
+    order = record_send_order<interface::policy::priority_send_order<2>>(prioritized_sends);
+    if (order != "0abxcdy")
+        fail_and_exit("expected the queued sends in weighted priority order \"0abxcdy\", but got \"%s\"\n", order.c_str());
+}
+
+static void test_send_priority_marking()
+{
+    udp::socket_raw server(udp::opts()
+                               .role(udp::role_e::SERVER)
+                               .port(1258)
+                               .ipv4_address("127.0.0.1"));
+    udp::socket_raw client(udp::opts()
+                               .role(udp::role_e::CLIENT)
+                               .port(1258)
+                               .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("priority marking open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+
+    // sent through the abstract interface, so that losing the priority on the way would show up as the default marking
+    interface::abstract &polymorphic_client = client;
+    auto expect_marking = [&](interface::priority_e priority, int expected_priority, int expected_tos)
+    {
+        uint8_t tx_data[] = "mark";
+        if (polymorphic_client.send(tx_data, sizeof(tx_data), std::chrono::seconds(1), priority) != interface::status_e::SUCCESS)
+            fail_and_exit("priority marking send error\n");
+        int so_priority     = -1;
+        int tos             = -1;
+        socklen_t opt_size  = sizeof(int);
+        const int socket_fd = client.readiness().fd;
+        if (getsockopt(socket_fd, SOL_SOCKET, SO_PRIORITY, &so_priority, &opt_size) != 0 ||
+            getsockopt(socket_fd, IPPROTO_IP, IP_TOS, &tos, &opt_size) != 0)
+            fail_and_exit("priority marking getsockopt error\n");
+        if (so_priority != expected_priority || tos != expected_tos)
+            fail_and_exit("expected SO_PRIORITY %d and IP_TOS %d, but got %d and %d\n", expected_priority, expected_tos, so_priority, tos);
+
+        uint8_t rx_data[16] = {};
+        if (server.receive(rx_data, sizeof(rx_data), std::chrono::seconds(1)).status != interface::status_e::SUCCESS)
+            fail_and_exit("priority marking receive error\n");
+    };
+
+    // high priority sends are marked as interactive, and as DSCP 46 (expedited forwarding), until a normal one resets them
+    expect_marking(interface::priority_e::HIGH, 6, 46 << 2);
+    expect_marking(interface::priority_e::NORMAL, 0, 0);
+}
+
+static void test_coalesced_sends()
+{
+    // small sends should be packed into one datagram, each prefixed with its length
+    {
+        udp::socket plain_server(udp::opts()
+                                     .role(udp::role_e::SERVER)
+                                     .port(1244)
+                                     .ipv4_address("127.0.0.1"));
+        udp::socket client(udp::opts()
+                               .role(udp::role_e::CLIENT)
+                               .port(1244)
+                               .ipv4_address("127.0.0.1")
+                               .coalesce(1400u, std::chrono::milliseconds(20)));
+        if (!plain_server.is_open() || !client.is_open())
+            fail_and_exit("coalescing open error: %s, %s\n", plain_server.open_status().c_str(), client.open_status().c_str());
+
+        for (const char *message : {"a", "bb", "ccc"})
+            if (client.send(reinterpret_cast<const uint8_t *>(message), strlen(message)) != interface::status_e::SUCCESS)
+                fail_and_exit("coalesced send error\n");
+
+        const uint8_t expected[] = {1, 'a', 2, 'b', 'b', 3, 'c', 'c', 'c'};
+        uint8_t rx_data[100]     = {};
+        auto result              = plain_server.receive(rx_data, sizeof(rx_data), std::chrono::seconds(2));
+        if (result.status != interface::status_e::SUCCESS || result.size != sizeof(expected) || memcmp(rx_data, expected, sizeof(expected)) != 0)
+            fail_and_exit("expected the sends packed into one %zu byte datagram, but got %s with %zu bytes\n",
+                          sizeof(expected), result.status.c_str(), result.size);
+    }
+
+    // a packed datagram that can't be sent at all should close the socket, and fail the send waiting behind it with the
+    // error that closed it, rather than only as not open
+    {
+        udp::socket client(udp::opts()
+                               .role(udp::role_e::CLIENT)
+                               .port(1259)
+                               .ipv4_address("255.255.255.255") // without SO_BROADCAST, so sending is refused with EACCES
+                               .coalesce(1400u, std::chrono::seconds(10)));
+        if (!client.is_open())
+            fail_and_exit("coalescing broadcast open error: %s\n", client.open_status().c_str());
+
+        uint8_t tx_data[3000] = {};
+        if (client.send(tx_data, 16u) != interface::status_e::SUCCESS)
+            fail_and_exit("expected the small send to be packed\n");
+        auto status = client.send(tx_data, sizeof(tx_data));
+        if (status != interface::status_e::SEE_ERROR_CODE || status.get_error_code() != EACCES || client.is_open() ||
+            client.coalesced_sends_dropped() != 0u)
+            fail_and_exit("expected the failed flush to fail the next send with EACCES, but got %s\n", status.c_str());
+    }
+
+    // and a coalescing receiver should unpack them back into one message per receive, including ones too big, or too
+    // important, to be packed
+    {
+        constexpr size_t num_sends = 200;
+        udp::socket server(udp::opts()
+                               .role(udp::role_e::SERVER)
+                               .port(1245)
+                               .ipv4_address("127.0.0.1")
+                               .coalesce(1400u, std::chrono::microseconds(500)));
+        udp::socket client(udp::opts()
+                               .role(udp::role_e::CLIENT)
+                               .port(1245)
+                               .ipv4_address("127.0.0.1")
+                               .coalesce(1400u, std::chrono::microseconds(500)));
+        if (!server.is_open() || !client.is_open())
+            fail_and_exit("coalescing open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+
+        auto message_size = [](size_t i)
+        { return i == 100 ? 3000u : 16u + i % 49u; };
+        uint8_t tx_data[3000];
+        for (size_t i = 0; i < num_sends; i++)
+        {
+            memset(tx_data, static_cast<int>(i), message_size(i));
+            auto priority = i == 150 ? interface::priority_e::HIGH : interface::priority_e::NORMAL;
+            if (client.send(tx_data, message_size(i), std::chrono::seconds(1), priority) != interface::status_e::SUCCESS)
+                fail_and_exit("coalesced send %zu error\n", i);
+        }
+        uint8_t rx_data[3000];
+        for (size_t i = 0; i < num_sends; i++)
+        {
+            auto result = server.receive(rx_data, sizeof(rx_data), std::chrono::seconds(2));
+            if (result.status != interface::status_e::SUCCESS || result.size != message_size(i) || rx_data[0] != static_cast<uint8_t>(i) ||
+                rx_data[result.size - 1u] != static_cast<uint8_t>(i))
+                fail_and_exit("coalesced receive %zu error: %s with %zu bytes\n", i, result.status.c_str(), result.size);
+        }
+    }
+}
+
+static void test_receive_ring()
+{
+    // declared first, so that it outlives the server it's registered with
+    interface::receive_ring<8, 64> ring;
+    udp::socket server(udp::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(1246)
+                           .ipv4_address("127.0.0.1"));
+    udp::socket client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1246)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("receive ring open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+    if (server.register_receive_ring(ring) != interface::status_e::SUCCESS)
+        fail_and_exit("couldn't register the receive ring\n");
+    if (server.register_receive_ring(ring) != interface::status_e::WOULD_BLOCK)
+        fail_and_exit("expected a second receive ring to be rejected\n");
+
+    uint8_t rx_data[64];
+    if (server.receive(rx_data, std::chrono::milliseconds(10)).status != interface::status_e::UNSUPPORTED_OP)
+        fail_and_exit("expected receive to be unsupported while a receive ring is registered\n");
+
+    // send more than the ring holds while the consumer is busy, so that the management thread has to stall, and be woken
+    // again by the consumer returning slots
+    constexpr size_t num_sends = 100;
+    for (size_t i = 0; i < num_sends; i++)
+    {
+        uint8_t tx_data[8];
+        memset(tx_data, static_cast<int>(i), sizeof(tx_data));
+        if (client.send(tx_data, 1u + i % sizeof(tx_data)) != interface::status_e::SUCCESS)
+            fail_and_exit("receive ring send %zu error\n", i);
+        if (i == num_sends / 2)
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    for (size_t i = 0; i < num_sends; i++)
+    {
+        const interface::received_slot *p_slot = ring.wait_front(std::chrono::seconds(2));
+        if (p_slot == nullptr || p_slot->size != 1u + i % 8u || p_slot->data[0] != static_cast<uint8_t>(i))
+            fail_and_exit("receive ring slot %zu error: %zu bytes\n", i, p_slot == nullptr ? 0u : p_slot->size);
+        ring.pop();
+    }
+    if (ring.wait_front(std::chrono::milliseconds(10)) != nullptr)
+        fail_and_exit("expected the receive ring to be empty\n");
+
+    // and once unregistered, receive works again
+    server.unregister_receive_ring();
+    const uint8_t last[] = {42};
+    if (client.send(last) != interface::status_e::SUCCESS)
+        fail_and_exit("send after the receive ring error\n");
+    auto result = server.receive(rx_data, std::chrono::seconds(2));
+    if (result.status != interface::status_e::SUCCESS || result.size != 1u || rx_data[0] != 42u)
+        fail_and_exit("receive after the receive ring error: %s\n", result.status.c_str());
+}
+
+static void test_receive_sizes()
+{
+    udp::socket server(udp::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(1247)
+                           .ipv4_address("127.0.0.1"));
+    udp::socket client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1247)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("receive size open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+
+    uint8_t tx_data[1000];
+    for (size_t i = 0; i < sizeof(tx_data); i++)
+        tx_data[i] = static_cast<uint8_t>(i);
+
+    // a datagram larger than the buffer should be reported as truncated
+    if (client.send(tx_data) != interface::status_e::SUCCESS)
+        fail_and_exit("receive size send error\n");
+    uint8_t small_rx_data[100];
+    auto result = server.receive(small_rx_data, std::chrono::seconds(2));
+    if (result.status != interface::status_e::SUCCESS || result.size != sizeof(small_rx_data) || !result.truncated ||
+        small_rx_data[99] != 99u)
+        fail_and_exit("expected a truncated receive, but got %s with %zu bytes\n", result.status.c_str(), result.size);
+
+    // and a growable container should be grown to fit each datagram exactly
+    std::vector<uint8_t> rx_data;
+    for (size_t size : {sizeof(tx_data), size_t{10}, size_t{0}})
+    {
+        if (client.send(tx_data, size) != interface::status_e::SUCCESS)
+            fail_and_exit("receive size send error\n");
+        result = server.receive_into(rx_data, std::chrono::seconds(2));
+        if (result.status != interface::status_e::SUCCESS || result.truncated || result.size != size || rx_data.size() != size ||
+            memcmp(rx_data.data(), tx_data, size) != 0)
+            fail_and_exit("expected a %zu byte receive, but got %s with %zu bytes\n", size, result.status.c_str(), result.size);
+    }
+    if (rx_data.capacity() > 2u * sizeof(tx_data))
+        fail_and_exit("expected the container to only grow to the largest datagram, not %zu bytes\n", rx_data.capacity());
+
+    // a container that throws while growing on the management thread should get the message truncated, instead of the
+    // exception terminating the process
+    struct limited_container
+    {
+        std::vector<uint8_t> bytes{};
+        void resize(size_t size)
+        {
+            if (size > 100u)
+                throw std::bad_alloc();
+            bytes.resize(size);
+        }
+        uint8_t *data() { return bytes.data(); }
+        size_t size() const { return bytes.size(); }
+        size_t capacity() const { return bytes.capacity(); }
+    };
+    limited_container limited;
+    limited.resize(100u);
+    if (client.send(tx_data) != interface::status_e::SUCCESS)
+        fail_and_exit("receive size send error\n");
+    result = server.receive_into(limited, std::chrono::seconds(2));
+    if (result.status != interface::status_e::SUCCESS || !result.truncated || result.size != limited.bytes.capacity() ||
+        memcmp(limited.data(), tx_data, result.size) != 0)
+        fail_and_exit("expected a truncated receive into the container, but got %s with %zu bytes\n", result.status.c_str(), result.size);
+}
+
+static void test_pooled_receive_ring()
+{
+    // huge pages and NUMA binding are usually unavailable here, so this mostly checks that the pool falls back gracefully
+    interface::buffer_pool pool(16u, 1500u, interface::numa_node_of_calling_thread());
+    if (!pool || pool.buffer_count() != 16u || pool.buffer_size() < 1500u || pool.page_backing() == interface::page_backing_e::NONE)
+        fail_and_exit("buffer pool mapping error\n");
+    for (size_t i = 0; i < pool.buffer_count(); i++)
+        if (reinterpret_cast<uintptr_t>(pool.buffer(i)) % interface::cache_line_size != 0u)
+            fail_and_exit("expected buffer pool buffer %zu to be cache line aligned\n", i);
+    if (pool.page_backing() == interface::page_backing_e::HUGE_PAGES)
+        fail_and_exit("expected a pool smaller than a huge page not to be backed by one\n");
+
+    // a pool too large to address shouldn't wrap around to a small mapping, and a ring over it shouldn't be registered
+    interface::buffer_pool unaddressable_pool(SIZE_MAX / 128u + 2u, 128u); // whose size wraps around to 128 bytes
+    interface::pooled_receive_ring empty_ring(unaddressable_pool);
+    if (unaddressable_pool || unaddressable_pool.buffer_count() != 0u || unaddressable_pool.page_backing() != interface::page_backing_e::NONE)
+        fail_and_exit("expected an unaddressable buffer pool not to be mapped\n");
+
+    interface::pooled_receive_ring ring(pool);
+    udp::socket server(udp::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(1248)
+                           .ipv4_address("127.0.0.1"));
+    udp::socket client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1248)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("pooled receive ring open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+    if (auto status = server.register_receive_ring(empty_ring); status != interface::status_e::SEE_ERROR_CODE || status.get_error_code() != ENOMEM)
+        fail_and_exit("expected a receive ring without slots to be rejected, but got %s\n", status.c_str());
+    if (server.register_receive_ring(ring) != interface::status_e::SUCCESS)
+        fail_and_exit("couldn't register the pooled receive ring\n");
+
+    constexpr size_t num_sends = 40;
+    uint8_t tx_data[1500];
+    for (size_t i = 0; i < num_sends; i++)
+    {
+        memset(tx_data, static_cast<int>(i), sizeof(tx_data));
+        if (client.send(tx_data, 100u + i * 30u) != interface::status_e::SUCCESS)
+            fail_and_exit("pooled receive ring send %zu error\n", i);
+    }
+    for (size_t i = 0; i < num_sends; i++)
+    {
+        const interface::received_slot *p_slot = ring.wait_front(std::chrono::seconds(2));
+        if (p_slot == nullptr || p_slot->size != 100u + i * 30u || p_slot->truncated || p_slot->data[p_slot->size - 1u] != static_cast<uint8_t>(i))
+            fail_and_exit("pooled receive ring slot %zu error: %zu bytes\n", i, p_slot == nullptr ? 0u : p_slot->size);
+        ring.pop();
+    }
+    server.unregister_receive_ring();
+}
+
+static void test_crc32c_integrity()
+{
+    // the standard check value, and every implementation agreeing with the table driven one, across the interleaved block
+    // sizes, odd lengths, misaligned starts, and continued CRCs
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    if (interface::crc32c(check, sizeof(check)) != 0xE3069283u || interface::crc32c_table_driven(0u, check, sizeof(check)) != 0xE3069283u)
+        fail_and_exit("crc32c check value error using %s\n", interface::crc32c_best_implementation().name);
+    static uint8_t block[3u * 2048u * 2u + 64u];
+    for (size_t i = 0; i < sizeof(block); i++)
+        block[i] = static_cast<uint8_t>(i * 2654435761u >> 13u);
+    for (size_t size = 0; size + 3u <= sizeof(block); size += size < 64u ? 1u : 61u)
+    {
+        const uint32_t expected = interface::crc32c_table_driven(0u, block + 3u, size);
+        const size_t half       = size / 2u;
+        if (interface::crc32c(block + 3u, size) != expected || interface::crc32c(block + 3u + half, size - half, interface::crc32c(block + 3u, half)) != expected)
+            fail_and_exit("crc32c mismatch using %s for %zu bytes\n", interface::crc32c_best_implementation().name, size);
+    }
+
+    udp::socket server(udp::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(1249)
+                           .ipv4_address("127.0.0.1"));
+    udp::socket client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1249)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("crc32c integrity open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+    interface::crc32c_integrity<> checked_server(server);
+    interface::crc32c_integrity<> checked_client(client);
+
+    // a corrupted message (sent without a trailer, around the decorator) is dropped, and the next intact one is received
+    uint8_t tx_data[64];
+    memset(tx_data, 0x5A, sizeof(tx_data));
+    if (client.send(tx_data, sizeof(tx_data)) != interface::status_e::SUCCESS || client.send(tx_data, 2u) != interface::status_e::SUCCESS)
+        fail_and_exit("crc32c integrity corrupt send error\n");
+    for (size_t i = 0; i < 10u; i++)
+    {
+        tx_data[0] = static_cast<uint8_t>(i);
+        if (checked_client.send(tx_data, 10u + i) != interface::status_e::SUCCESS)
+            fail_and_exit("crc32c integrity send %zu error\n", i);
+    }
+    for (size_t i = 0; i < 10u; i++)
+    {
+        uint8_t rx_data[64 + interface::crc32c_integrity<>::trailer_size];
+        auto result = checked_server.receive(rx_data, std::chrono::seconds(1));
+        if (result.status != interface::status_e::SUCCESS || result.size != 10u + i || rx_data[0] != static_cast<uint8_t>(i))
+            fail_and_exit("crc32c integrity receive %zu error: %s, %zu bytes\n", i, result.status.c_str(), result.size);
+    }
+    const interface::integrity_stats stats = checked_server.stats();
+    if (stats.verified != 10u || stats.corrupt != 2u)
+        fail_and_exit("expected 10 verified and 2 corrupt messages, not %llu and %llu\n",
+                      static_cast<unsigned long long>(stats.verified), static_cast<unsigned long long>(stats.corrupt));
+
+    // a message without room for its trailer is reported instead of dropped, and oversized sends are rejected
+    if (checked_client.send(tx_data, 8u) != interface::status_e::SUCCESS)
+        fail_and_exit("crc32c integrity send error\n");
+    uint8_t small[8];
+    auto result = checked_server.receive(small, std::chrono::seconds(1));
+    if (result.status != interface::status_e::SEE_ERROR_CODE || result.status.get_error_code() != EMSGSIZE)
+        fail_and_exit("expected an EMSGSIZE error, not %s\n", result.status.c_str());
+    static uint8_t too_large[1473];
+    if (checked_client.send(too_large, sizeof(too_large)) != interface::status_e::SEE_ERROR_CODE)
+        fail_and_exit("expected a message larger than max_message_size to be rejected\n");
+}
+
+static void test_sequencing()
+{
+    udp::socket server(udp::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(1255)
+                           .ipv4_address("127.0.0.1"));
+    udp::socket client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1255)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("sequencing open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+    interface::sequencing<> sequenced_server(server);
+    interface::sequencing<> sequenced_client(client);
+
+    // the first message is numbered by the decorator, and the rest are numbered by hand (sent around the decorator) to
+    // simulate a lossy, duplicating, reordering network, including a message too short to hold a sequence number
+    uint8_t tx_data[16] = {0xAB};
+    if (sequenced_client.send(tx_data, 1u) != interface::status_e::SUCCESS)
+        fail_and_exit("sequencing send error\n");
+    const uint32_t sequences[] = {1u, 3u, 2u, 2u, 6u, UINT32_MAX, 200u, 100u, 102u, 101u};
+    for (const uint32_t sequence : sequences)
+    {
+        size_t size = 1u;
+        if (sequence != UINT32_MAX)
+            for (size_t i = 0; i < interface::sequencing<>::sequence_size; i++)
+                tx_data[size++] = static_cast<uint8_t>(sequence >> (8u * i));
+        if (client.send(tx_data, size) != interface::status_e::SUCCESS)
+            fail_and_exit("sequencing send %u error\n", sequence);
+    }
+
+    const uint32_t expected[] = {0u, 1u, 3u, 2u, 2u, 6u, 200u, 100u, 102u, 101u};
+    for (const uint32_t sequence : expected)
+    {
+        uint8_t rx_data[16];
+        auto result = sequenced_server.receive(rx_data, std::chrono::seconds(1));
+        if (result.status != interface::status_e::SUCCESS || result.size != 1u || rx_data[0] != 0xAB || sequenced_server.last_sequence() != sequence)
+            fail_and_exit("sequencing receive %u error: %s, %zu bytes, sequence %u\n", sequence, result.status.c_str(), result.size,
+                          sequenced_server.last_sequence());
+    }
+
+    // 4, 5, and 7 to 199 were never received, and 2 arrived late (after 3), 2 arrived twice, and 100 was too far behind to
+    // tell, so the numbering restarted from it, after which 101 is just reordered (after 102)
+    const interface::sequence_stats stats = sequenced_server.stats();
+    if (stats.received != 10u || stats.lost != 195u || stats.duplicates != 1u || stats.reordered != 2u || stats.restarts != 1u ||
+        stats.malformed != 1u)
+        fail_and_exit("unexpected sequencing stats: %llu received, %llu lost, %llu duplicates, %llu reordered, %llu restarts, %llu malformed\n",
+                      static_cast<unsigned long long>(stats.received), static_cast<unsigned long long>(stats.lost),
+                      static_cast<unsigned long long>(stats.duplicates), static_cast<unsigned long long>(stats.reordered),
+                      static_cast<unsigned long long>(stats.restarts), static_cast<unsigned long long>(stats.malformed));
+
+    // a send that fails doesn't use up a sequence number, so it's not counted as lost by the receiver
+    interface::sequencing<> renumbered_server(server);
+    interface::sequencing<> renumbered_client(client);
+    if (renumbered_client.send(tx_data, 1u) != interface::status_e::SUCCESS || client.close() != interface::status_e::SUCCESS ||
+        renumbered_client.send(tx_data, 1u) != interface::status_e::NOT_OPEN || client.open() != interface::status_e::SUCCESS ||
+        renumbered_client.send(tx_data, 1u) != interface::status_e::SUCCESS)
+        fail_and_exit("sequencing failed send error\n");
+    for (const uint32_t sequence : {0u, 1u})
+    {
+        uint8_t rx_data[16];
+        auto result = renumbered_server.receive(rx_data, std::chrono::seconds(1));
+        if (result.status != interface::status_e::SUCCESS || renumbered_server.last_sequence() != sequence)
+            fail_and_exit("expected sequence %u after a failed send, but got %s with sequence %u\n", sequence, result.status.c_str(),
+                          renumbered_server.last_sequence());
+    }
+    if (renumbered_server.stats().lost != 0u)
+        fail_and_exit("expected a failed send not to be counted as lost\n");
+
+    // concurrent sends each reserve a different number, without waiting on each other's sends
+    constexpr size_t num_senders = 4u, sends_per_sender = 50u;
+    std::vector<std::thread> senders;
+    for (size_t t = 0; t < num_senders; t++)
+        senders.emplace_back([&]()
+                             {
+                                 for (size_t i = 0; i < sends_per_sender; i++)
+                                     if (renumbered_client.send(tx_data, 1u) != interface::status_e::SUCCESS)
+                                         fail_and_exit("concurrent sequencing send error\n"); });
+    for (auto &sender : senders)
+        sender.join();
+    bool numbered[2u + num_senders * sends_per_sender] = {true, true};
+    for (size_t n = 0; n < num_senders * sends_per_sender; n++)
+    {
+        uint8_t rx_data[16];
+        auto result             = renumbered_server.receive(rx_data, std::chrono::seconds(1));
+        const uint32_t sequence = renumbered_server.last_sequence();
+        if (result.status != interface::status_e::SUCCESS || sequence >= sizeof(numbered) || numbered[sequence])
+            fail_and_exit("concurrent sequencing receive %zu error: %s, sequence %u\n", n, result.status.c_str(), sequence);
+        numbered[sequence] = true;
+    }
+}
+
+static void test_jitter_buffer()
+{
+    udp::socket server(udp::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(1256)
+                           .ipv4_address("127.0.0.1"));
+    udp::socket client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1256)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("jitter buffer open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+    interface::sequencing<> sequenced_server(server);
+    interface::jitter_buffer<8> ordered_server(sequenced_server, std::chrono::milliseconds(50));
+
+    // messages are numbered by hand (sent around a sequencing decorator) to simulate a reordering, lossy network
+    auto send_numbered = [&](uint32_t sequence)
+    {
+        uint8_t tx_data[1 + interface::sequencing<>::sequence_size] = {static_cast<uint8_t>(sequence)};
+        for (size_t i = 0; i < interface::sequencing<>::sequence_size; i++)
+            tx_data[1u + i] = static_cast<uint8_t>(sequence >> (8u * i));
+        if (client.send(tx_data, sizeof(tx_data)) != interface::status_e::SUCCESS)
+            fail_and_exit("jitter buffer send %u error\n", sequence);
+    };
+    auto expect_delivered = [&](std::initializer_list<uint32_t> sequences)
+    {
+        for (const uint32_t sequence : sequences)
+        {
+            uint8_t rx_data[16];
+            auto result = ordered_server.receive(rx_data, std::chrono::seconds(1));
+            if (result.status != interface::status_e::SUCCESS || result.size != 1u || rx_data[0] != static_cast<uint8_t>(sequence))
+                fail_and_exit("jitter buffer expected %u, not %u: %s\n", sequence, rx_data[0], result.status.c_str());
+        }
+    };
+
+    // 2 is held until 1 fills the gap, and 5 is held until the hold time passes, since 4 doesn't arrive in time
+    for (const uint32_t sequence : {0u, 2u, 1u, 3u, 5u})
+        send_numbered(sequence);
+    const auto start = std::chrono::steady_clock::now();
+    expect_delivered({0u, 1u, 2u, 3u, 5u});
+    if (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(40))
+        fail_and_exit("expected the jitter buffer to hold 5 until the hold time passed\n");
+
+    // 4 arrives after being skipped, so it's dropped, and 20 is too far ahead to hold, so it releases 7 and then itself
+    for (const uint32_t sequence : {4u, 7u, 20u, 21u})
+        send_numbered(sequence);
+    expect_delivered({7u, 20u, 21u});
+    if (ordered_server.held() != 0u)
+        fail_and_exit("expected the jitter buffer to be empty\n");
+
+    // 17 is late, but 2 is more than a window behind, like after the sender restarted, so the order restarts from it
+    for (const uint32_t sequence : {17u, 2u, 4u, 3u})
+        send_numbered(sequence);
+    expect_delivered({2u, 3u, 4u});
+
+    const interface::jitter_stats stats = ordered_server.stats();
+    if (stats.in_order != 5u || stats.released != 6u || stats.skipped != 14u || stats.late != 2u || stats.resyncs != 1u)
+        fail_and_exit("unexpected jitter buffer stats: %llu in order, %llu released, %llu skipped, %llu late, %llu resyncs\n",
+                      static_cast<unsigned long long>(stats.in_order), static_cast<unsigned long long>(stats.released),
+                      static_cast<unsigned long long>(stats.skipped), static_cast<unsigned long long>(stats.late),
+                      static_cast<unsigned long long>(stats.resyncs));
+}
+
+// drops the datagrams whose send index is in "to_drop", to simulate a lossy link
+class dropping_decorator : public interface::decorator
+{
+    std::vector<size_t> to_drop;
+    size_t num_sent = 0u;
+
+public:
+    dropping_decorator(interface::abstract &inner_interface, std::vector<size_t> indexes_to_drop)
+        : interface::decorator(inner_interface), to_drop(std::move(indexes_to_drop))
+    {
+    }
+    using interface::decorator::send;
+    interface::status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time,
+                             interface::priority_e priority) override
+    {
+        for (const size_t index : to_drop)
+            if (index == num_sent)
+            {
+                num_sent++;
+                return interface::status_e::SUCCESS;
+            }
+        num_sent++;
+        return inner.send(data, size, end_time, priority);
+    }
+};
+
+// holds back the datagram whose send index is "held_index", and sends it right after the one at "release_after", to simulate
+// a datagram arriving late
+class delaying_decorator : public interface::decorator
+{
+    size_t held_index, release_after;
+    std::vector<uint8_t> held{};
+    size_t num_sent = 0u;
+
+public:
+    delaying_decorator(interface::abstract &inner_interface, size_t index_to_hold, size_t index_to_release_after)
+        : interface::decorator(inner_interface), held_index(index_to_hold), release_after(index_to_release_after)
+    {
+    }
+    using interface::decorator::send;
+    interface::status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time,
+                             interface::priority_e priority) override
+    {
+        const size_t index = num_sent++;
+        if (index == held_index)
+        {
+            held.assign(data, data + size);
+            return interface::status_e::SUCCESS;
+        }
+        const interface::status_e status = inner.send(data, size, end_time, priority);
+        if (index != release_after || status != interface::status_e::SUCCESS)
+            return status;
+        return inner.send(held.data(), held.size(), end_time, priority);
+    }
+};
+
+static void test_xor_fec()
+{
+    // every XOR implementation matches the scalar one, across vector widths and misaligned starts
+    static uint8_t expected[300];
+    static uint8_t actual[300];
+    static uint8_t src[300];
+    for (size_t i = 0; i < sizeof(src); i++)
+        src[i] = static_cast<uint8_t>(i * 2654435761u >> 11u);
+    for (size_t size = 0; size + 1u <= sizeof(src); size += 1u + size / 8u)
+    {
+        memset(expected, 0x3C, sizeof(expected));
+        memset(actual, 0x3C, sizeof(actual));
+        interface::xor_into_scalar(expected + 1u, src, size);
+        interface::xor_into(actual + 1u, src, size);
+        if (memcmp(expected, actual, sizeof(actual)) != 0)
+            fail_and_exit("xor mismatch using %s for %zu bytes\n", interface::xor_best_implementation().name, size);
+    }
+
+    udp::socket server(udp::opts()
+                           .role(udp::role_e::SERVER)
+                           .port(1257)
+                           .ipv4_address("127.0.0.1"));
+    udp::socket client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1257)
+                           .ipv4_address("127.0.0.1"));
+    if (!server.is_open() || !client.is_open())
+        fail_and_exit("fec open error: %s, %s\n", server.open_status().c_str(), client.open_status().c_str());
+
+    // with 2 interleaved groups of 4, datagrams go out as: messages 0-6, parity, 7, parity, 8-14, parity, 15, parity. So
+    // dropping the back-to-back datagrams of messages 2 and 3 loses one message from each group, which are both rebuilt,
+    // while dropping messages 8 and 10 (datagrams 10 and 12) loses two from the same group, which can't be rebuilt
+    dropping_decorator lossy_client(client, {2u, 3u, 10u, 12u});
+    interface::xor_fec<4, 2> protected_client(lossy_client);
+    interface::xor_fec<4, 2> protected_server(server);
+
+    constexpr size_t num_messages = 16u;
+    for (size_t i = 0; i < num_messages; i++)
+    {
+        uint8_t tx_data[200];
+        memset(tx_data, static_cast<int>(i), sizeof(tx_data));
+        if (protected_client.send(tx_data, 10u + i * 7u) != interface::status_e::SUCCESS)
+            fail_and_exit("fec send %zu error\n", i);
+    }
+
+    bool received[num_messages] = {};
+    for (size_t n = 0; n < num_messages - 2u; n++)
+    {
+        uint8_t rx_data[200 + interface::xor_fec<4, 2>::trailer_size];
+        auto result = protected_server.receive(rx_data, std::chrono::seconds(1));
+        const size_t i = rx_data[0];
+        if (result.status != interface::status_e::SUCCESS || i >= num_messages || received[i] || result.size != 10u + i * 7u ||
+            rx_data[result.size - 1u] != static_cast<uint8_t>(i))
+            fail_and_exit("fec receive %zu error: %s, %zu bytes\n", n, result.status.c_str(), result.size);
+        received[i] = true;
+    }
+    if (received[8] || received[10])
+        fail_and_exit("expected messages 8 and 10 to be unrecoverable\n");
+    uint8_t rx_data[200 + interface::xor_fec<4, 2>::trailer_size];
+    auto result = protected_server.receive(rx_data, std::chrono::milliseconds(50));
+    if (result.status != interface::status_e::TIMED_OUT)
+        fail_and_exit("expected nothing else to be received, not: %s\n", result.status.c_str());
+    const interface::fec_stats stats = protected_server.stats();
+    if (stats.recovered != 2u || stats.duplicates != 0u || stats.malformed != 0u)
+        fail_and_exit("unexpected fec stats: %llu recovered, %llu duplicates, %llu malformed\n",
+                      static_cast<unsigned long long>(stats.recovered), static_cast<unsigned long long>(stats.duplicates),
+                      static_cast<unsigned long long>(stats.malformed));
+
+    // a message rebuilt from a later group, whose messages are larger than the last group's parity and its trailer, should
+    // match byte for byte. Datagrams go out as: messages 0 and 1, parity, 2 and 3, parity, so message 2 is dropped.
+    dropping_decorator lossy_pair_client(client, {3u});
+    interface::xor_fec<2> protected_pair_client(lossy_pair_client);
+    interface::xor_fec<2> protected_pair_server(server);
+    auto fill_message = [](uint8_t *data, size_t i)
+    {
+        for (size_t j = 0; j < 30u; j++)
+            data[j] = static_cast<uint8_t>(i * 64u + j);
+    };
+    const size_t pair_sizes[] = {10u, 10u, 30u, 30u};
+    for (size_t i = 0; i < 4u; i++)
+    {
+        uint8_t tx_data[30];
+        fill_message(tx_data, i);
+        if (protected_pair_client.send(tx_data, pair_sizes[i]) != interface::status_e::SUCCESS)
+            fail_and_exit("fec pair send %zu error\n", i);
+    }
+    for (const size_t i : {0u, 1u, 3u, 2u})
+    {
+        uint8_t expected_data[30];
+        fill_message(expected_data, i);
+        result = protected_pair_server.receive(rx_data, std::chrono::seconds(1));
+        if (result.status != interface::status_e::SUCCESS || result.size != pair_sizes[i] || memcmp(rx_data, expected_data, result.size) != 0)
+            fail_and_exit("fec pair receive %zu error: %s, %zu bytes\n", i, result.status.c_str(), result.size);
+    }
+    if (protected_pair_server.stats().recovered != 1u)
+        fail_and_exit("expected message 2 to be rebuilt\n");
+
+    // a late parity for group 0 arriving mid-way through group 2, which shares its slot, is ignored, rather than evicting
+    // group 2. Datagrams go out as: messages 0 and 1, parity 0, 2 and 3, parity 1, 4 and 5, parity 2, but parity 0 is held
+    // back until after message 4, and then message 5 is dropped, which is rebuilt from parity 2.
+    dropping_decorator lossy_late_client(client, {7u});
+    delaying_decorator late_client(lossy_late_client, 2u, 6u);
+    interface::xor_fec<2> protected_late_client(late_client);
+    interface::xor_fec<2> protected_late_server(server);
+    for (size_t i = 0; i < 6u; i++)
+    {
+        uint8_t tx_data[30];
+        fill_message(tx_data, i);
+        if (protected_late_client.send(tx_data, sizeof(tx_data)) != interface::status_e::SUCCESS)
+            fail_and_exit("fec late send %zu error\n", i);
+    }
+    for (size_t i = 0; i < 6u; i++)
+    {
+        uint8_t expected_data[30];
+        fill_message(expected_data, i);
+        result = protected_late_server.receive(rx_data, std::chrono::seconds(1));
+        if (result.status != interface::status_e::SUCCESS || result.size != sizeof(expected_data) ||
+            memcmp(rx_data, expected_data, result.size) != 0)
+            fail_and_exit("fec late receive %zu error: %s, %zu bytes\n", i, result.status.c_str(), result.size);
+    }
+    const interface::fec_stats late_stats = protected_late_server.stats();
+    if (late_stats.recovered != 1u || late_stats.late != 1u || late_stats.unrecoverable != 0u)
+        fail_and_exit("unexpected fec stats after a late parity: %llu recovered, %llu late, %llu unrecoverable\n",
+                      static_cast<unsigned long long>(late_stats.recovered), static_cast<unsigned long long>(late_stats.late),
+                      static_cast<unsigned long long>(late_stats.unrecoverable));
+}
+
+// records the sends made through it instead of sending them, and reports custom default timeouts, like an interface built
+// with a policy::timeouts other than the default one
+class recording_decorator : public interface::decorator
+{
+public:
+    using interface::decorator::decorator;
+    using interface::decorator::send;
+
+    std::vector<interface::priority_e> priorities{};
+    std::chrono::steady_clock::time_point last_end_time{};
+
+    std::chrono::nanoseconds default_receive_timeout() const override { return std::chrono::milliseconds(20); }
+    std::chrono::nanoseconds default_send_timeout() const override { return std::chrono::milliseconds(123); }
+    interface::status_e send(const uint8_t *const data, size_t size, std::chrono::steady_clock::time_point end_time,
+                             interface::priority_e priority) override
+    {
+        (void)data;
+        (void)size;
+        priorities.push_back(priority);
+        last_end_time = end_time;
+        return interface::status_e::SUCCESS;
+    }
+};
+
+static void test_decorator_forwarding()
+{
+    udp::socket client(udp::opts()
+                           .role(udp::role_e::CLIENT)
+                           .port(1269)
+                           .ipv4_address("127.0.0.1"));
+    if (!client.is_open())
+        fail_and_exit("decorator forwarding open error: %s\n", client.open_status().c_str());
+
+    // the default timeouts come from the wrapped interface, through every stage
+    recording_decorator recorder(client);
+    interface::crc32c_integrity<> checked(recorder);
+    interface::sequencing<> sequenced(checked);
+    interface::xor_fec<2> protected_stack(sequenced);
+    interface::crc32c_integrity<> checked_client(client);
+    if (checked_client.default_send_timeout() != client.default_send_timeout() ||
+        checked_client.default_receive_timeout() != client.default_receive_timeout() ||
+        protected_stack.default_send_timeout() != std::chrono::milliseconds(123))
+        fail_and_exit("expected decorators to report the default timeouts of the interface they wrap\n");
+    uint8_t tx_data[8] = {};
+    const auto before  = std::chrono::steady_clock::now();
+    if (protected_stack.send(tx_data, sizeof(tx_data)) != interface::status_e::SUCCESS)
+        fail_and_exit("decorator forwarding send error\n");
+    if (recorder.last_end_time < before + std::chrono::milliseconds(123) || recorder.last_end_time > before + std::chrono::seconds(1))
+        fail_and_exit("expected a send without a timeout to use the wrapped interface's default send timeout\n");
+    uint8_t rx_data[16];
+    const auto receive_start = std::chrono::steady_clock::now();
+    if (checked.receive(rx_data).status != interface::status_e::TIMED_OUT || std::chrono::steady_clock::now() - receive_start > std::chrono::seconds(1))
+        fail_and_exit("expected a receive without a timeout to use the wrapped interface's default receive timeout\n");
+
+    // the priority of a send reaches the wrapped interface through every stage, including the parity of the fec group
+    if (protected_stack.send(tx_data, sizeof(tx_data), std::chrono::seconds(1), interface::priority_e::HIGH) != interface::status_e::SUCCESS)
+        fail_and_exit("decorator forwarding priority send error\n");
+    const std::vector<interface::priority_e> expected = {interface::priority_e::NORMAL, interface::priority_e::HIGH,
+                                                         interface::priority_e::HIGH};
+    if (recorder.priorities != expected)
+        fail_and_exit("expected the send priorities to be forwarded through every stage\n");
+}
+
 static void test_send_receive_then_closures(size_t loop_iteration)
 {
     for (size_t i = 0; i < static_cast<size_t>(test_case_e::NUM_TEST_CASES); i++)
@@ -197,6 +1957,29 @@ int main()
     size_t total_tests = 1000;
     auto start_time    = std::chrono::steady_clock::now();
     thread_printf("Starting tests.\n"); // if we got here, the tests passed
+    test_status_reads_during_rx();
+    test_send_during_pending_rx();
+    test_wakeups_during_pending_rx();
+    test_lazy_and_retiring_threads();
+    test_custom_policies();
+    test_single_caller_policy();
+    test_unidirectional_sockets();
+    test_static_dispatch();
+    test_event_loop_driven_raw_sockets();
+    test_try_send_receive();
+    test_short_timeout_sends();
+    test_backend_wakeups();
+    test_send_orders();
+    test_send_priority_marking();
+    test_coalesced_sends();
+    test_receive_ring();
+    test_receive_sizes();
+    test_pooled_receive_ring();
+    test_crc32c_integrity();
+    test_sequencing();
+    test_jitter_buffer();
+    test_xor_fec();
+    test_decorator_forwarding();
     for (size_t i = 0; i <= total_tests; i++)
     {
         if (i % 100 == 0)